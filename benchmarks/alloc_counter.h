@@ -0,0 +1,29 @@
+/** 
+* @file alloc_counter.h
+* @brief Provides global heap allocations counter for benchmarks.
+*/
+
+#ifndef ALLOC_COUNTER_H
+
+    /**
+    * @def ALLOC_COUNTER_H
+    * @brief Include module macro.
+    */
+    #define ALLOC_COUNTER_H
+
+    #include <cstddef>
+
+    /**
+    * @class AllocCounter
+    * @brief Counts calls of global operator new. Operators are replaced in alloc_counter.cpp.
+    */
+    class AllocCounter {
+    public:
+	/**
+	* @returns count of heap allocations since program start.
+	* @brief Get heap allocations count.
+	*/
+        static std::size_t count() noexcept;
+    };
+
+#endif
@@ -0,0 +1,261 @@
+/**
+* @file bench_runner.h
+* @brief Provides basic benchmark runner for project.
+*/
+
+#ifndef BENCH_RUNNER_H
+
+    /**
+    * @def BENCH_RUNNER_H
+    * @brief Include module macro.
+    */
+    #define BENCH_RUNNER_H
+
+    #include "../src/include/spi_interface.h"
+    #include "alloc_counter.h"
+
+    #include <chrono>
+    #include <exception>
+    #include <iostream>
+    #include <optional>
+    #include <string>
+    #include <vector>
+
+    /**
+    * @tparam T type of value.
+    * @param value result of measured operation.
+    * @brief Keeps @c value alive, so compiler doesn't drop operation which result is not used.
+    */
+    template <typename T>
+    inline void doNotOptimize(const T& value) noexcept {
+    #if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+    #else
+        [[maybe_unused]] volatile T sink = value;
+    #endif
+    }
+
+    /**
+    * @struct BenchResult
+    * @brief Result of single benchmark. Values which are not measured by benchmark are empty.
+    */
+    struct BenchResult {
+        std::string name; ///< Name of the benchmark.
+        std::optional<double> opsPerSecond; ///< Wall-clock throughput.
+        std::optional<double> allocsPerOp; ///< Heap allocations per operation.
+        std::optional<double> transactionsPerOp; ///< SPI transactions (frames) per operation.
+        std::optional<double> deviceBytesPerSecond; ///< Throughput on device time, e.g. virtual clock of mock.
+        std::optional<double> edgesPerByte; ///< Pin level changes per transferred byte of bit-bang backend.
+        std::string error; ///< Exception message if benchmark failed.
+    };
+
+    /**
+    * @class BenchRunner
+    * @brief Benchmark runner class for project. Measures throughput, heap allocations and SPI transactions per operation.
+    * Results are printed as human readable lines immediately or collected and printed in machine-readable format by BenchRunner::print.
+    */
+    class BenchRunner {
+    public:
+	/**
+	* @enum Format
+	* @brief Output formats.
+	*/
+        enum Format : byte {
+            FORMAT_TEXT = 0, ///< Line per benchmark, printed immediately.
+            FORMAT_JSON = 1, ///< Single JSON document printed by BenchRunner::print.
+            FORMAT_CSV = 2 ///< CSV with header printed by BenchRunner::print.
+        };
+
+	/**
+	* @param format output format.
+	* @param filter only benchmarks which name contains @c filter are executed.
+	* @brief Constructs runner.
+	*/
+        explicit BenchRunner(const_type<Format> format = FORMAT_TEXT, const std::string& filter = "") : format(format), filter(filter) {}
+
+	/**
+	* @param name name of the benchmark.
+	* @param iterations count of operations to execute.
+	* @param func operation to measure.
+	* @param transactions counter of SPI transactions, e.g. reading MockBusStats::transactions.
+	* @brief Execute benchmark.
+	*/
+        template <typename Func, typename Counter>
+        void runBench(const std::string& name, const_type<dword> iterations, Func func, Counter transactions) {
+            if (name.find(filter) == std::string::npos)
+                return;
+
+            BenchResult result{name};
+            try {
+                // Warm up
+                func();
+
+                const auto allocations = AllocCounter::count();
+                const dword frames = transactions();
+                const auto start = std::chrono::steady_clock::now();
+                for (dword i = 0; i < iterations; ++i)
+                    func();
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                const dword framesDone = transactions() - frames;
+                const auto allocated = AllocCounter::count() - allocations;
+
+                const double seconds = std::chrono::duration<double>(elapsed).count();
+                result.opsPerSecond = seconds > 0 ? iterations / seconds : 0;
+                result.allocsPerOp = static_cast<double>(allocated) / iterations;
+                result.transactionsPerOp = static_cast<double>(framesDone) / iterations;
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            record(result);
+        }
+
+	/**
+	* @param name name of the benchmark.
+	* @param iterations count of operations to execute.
+	* @param func operation to measure.
+	* @brief Execute benchmark which doesn't use SPI.
+	*/
+        template <typename Func>
+        void runBench(const std::string& name, const_type<dword> iterations, Func func) {
+            runBench(name, iterations, func, [] { return dword{0}; });
+        }
+
+	/**
+	* @param name name of the benchmark.
+	* @param bytes count of bytes processed by device.
+	* @param elapsed device time taken, e.g. virtual clock of mock.
+	* @brief Report throughput measured on device time instead of host time.
+	*/
+        void reportThroughput(const std::string& name, const_type<dword> bytes, const_type<std::chrono::nanoseconds> elapsed) {
+            if (name.find(filter) == std::string::npos)
+                return;
+
+            const double seconds = std::chrono::duration<double>(elapsed).count();
+            BenchResult result{name};
+            result.deviceBytesPerSecond = seconds > 0 ? bytes / seconds : 0;
+            record(result);
+        }
+
+	/**
+	* @param name name of the benchmark.
+	* @param bytes count of bytes transferred.
+	* @param edges count of pin level changes, e.g. MockSpiPins::getEdgeCount.
+	* @brief Report pin edges per byte of bit-bang backend.
+	*/
+        void reportEdges(const std::string& name, const_type<dword> bytes, const_type<dword> edges) {
+            if (name.find(filter) == std::string::npos)
+                return;
+
+            BenchResult result{name};
+            result.edgesPerByte = bytes ? static_cast<double>(edges) / bytes : 0;
+            record(result);
+        }
+
+	/**
+	* @param name name of the benchmark.
+	* @return whether benchmark passes filter. Use to skip expensive preparation.
+	*/
+        bool selected(const std::string& name) const {
+            return name.find(filter) != std::string::npos;
+        }
+
+	/**
+	* @brief Print collected results in machine-readable format. Does nothing for BenchRunner::FORMAT_TEXT.
+	*/
+        void print() const {
+            if (format == FORMAT_JSON) {
+                std::cout << "{\"benchmarks\": [";
+                for (std::size_t i = 0; i < results.size(); ++i) {
+                    const BenchResult& result = results[i];
+                    std::cout << (i ? ",\n  " : "\n  ") << "{\"name\": \"" << result.name << "\""
+                              << ", \"ops_per_second\": " << json(result.opsPerSecond)
+                              << ", \"allocs_per_op\": " << json(result.allocsPerOp)
+                              << ", \"transactions_per_op\": " << json(result.transactionsPerOp)
+                              << ", \"device_bytes_per_second\": " << json(result.deviceBytesPerSecond)
+                              << ", \"edges_per_byte\": " << json(result.edgesPerByte)
+                              << ", \"error\": " << (result.error.empty() ? "null" : "\"" + escape(result.error) + "\"") << "}";
+                }
+                std::cout << "\n]}" << std::endl;
+            } else if (format == FORMAT_CSV) {
+                std::cout << "name,ops_per_second,allocs_per_op,transactions_per_op,device_bytes_per_second,edges_per_byte,error\n";
+                for (const BenchResult& result : results)
+                    std::cout << result.name << ',' << csv(result.opsPerSecond) << ',' << csv(result.allocsPerOp) << ','
+                              << csv(result.transactionsPerOp) << ',' << csv(result.deviceBytesPerSecond) << ',' << csv(result.edgesPerByte) << ",\"" << escape(result.error, '"') << "\"\n";
+                std::cout << std::flush;
+            }
+        }
+
+    private:
+	/**
+	* @brief Output format.
+	*/
+        Format format;
+
+	/**
+	* @brief Substring of names of executed benchmarks.
+	*/
+        std::string filter;
+
+	/**
+	* @brief Collected results.
+	*/
+        std::vector<BenchResult> results;
+
+	/**
+	* @param result result of the benchmark.
+	* @brief Collect result, print it immediately for BenchRunner::FORMAT_TEXT.
+	*/
+        void record(const BenchResult& result) {
+            results.push_back(result);
+            if (format != FORMAT_TEXT)
+                return;
+
+            if (!result.error.empty()) {
+                std::cout << "[FAIL] " << result.name << ": " << result.error << std::endl;
+                return;
+            }
+            std::cout << "[BENCH] " << result.name << ":";
+            if (result.opsPerSecond)
+                std::cout << " " << *result.opsPerSecond << " ops/s"
+                          << ", " << *result.allocsPerOp << " allocs/op"
+                          << ", " << *result.transactionsPerOp << " transactions/op";
+            if (result.deviceBytesPerSecond)
+                std::cout << " " << *result.deviceBytesPerSecond / 1024 << " KiB/s device time";
+            if (result.edgesPerByte)
+                std::cout << " " << *result.edgesPerByte << " edges/byte";
+            std::cout << std::endl;
+        }
+
+	/**
+	* @param value measured value.
+	* @return JSON number or null.
+	*/
+        static std::string json(const std::optional<double>& value) {
+            return value ? std::to_string(*value) : "null";
+        }
+
+	/**
+	* @param text string to put into quoted field.
+	* @param prefix escape symbol: backslash for JSON, quote for CSV.
+	* @return @c text with escaped quotes and escape symbols.
+	*/
+        static std::string escape(const std::string& text, const char prefix = '\\') {
+            std::string result;
+            for (const char symbol : text) {
+                if (symbol == '"' || symbol == prefix)
+                    result += prefix;
+                result += symbol;
+            }
+            return result;
+        }
+
+	/**
+	* @param value measured value.
+	* @return CSV field, empty if value is not measured.
+	*/
+        static std::string csv(const std::optional<double>& value) {
+            return value ? std::to_string(*value) : "";
+        }
+    };
+
+#endif
@@ -0,0 +1,469 @@
+/**
+* @file main.cpp
+* @brief Main file for benchmarks.
+*
+* Usage: <TT>bench_run [--format=text|json|csv] [--filter=substring] [--replay=trace]</TT>. Machine-readable formats print single document after all benchmarks are done.
+* With @c --replay only trace file written from SpiTraceRecorder::snapshot is replayed against MockSpi.
+*/
+
+#include "../src/include/eeprom_25lc040a_cache.h"
+#include "../src/include/eeprom_25xx_scheduler.h"
+#include "../src/include/eeprom_25xx_streambuf.h"
+#include "../src/include/mock_nor_flash.h"
+#include "../src/include/mock_spi_bus.h"
+#include "../src/include/mock_spi_driver.h"
+#include "../src/include/mock_spi_pins.h"
+#include "../src/include/spi_trace.h"
+#include "bench_runner.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+/**
+* @brief Iterations count of every benchmark.
+*/
+constexpr dword ITERATIONS = 100000;
+
+/**
+* @brief Count of precomputed addresses of random access benchmarks.
+*/
+constexpr dword RANDOM_ADDRESSES = 4096;
+
+/**
+* @brief Count of reads of every thread in single operation of shared bus benchmarks.
+*/
+constexpr dword BUS_READS = 1000;
+
+/**
+* @brief Count of field writes of every client thread in single operation of scheduler benchmarks.
+*/
+constexpr dword CLIENT_WRITES = 64;
+
+/**
+* @brief Count of replays of trace in single benchmark.
+*/
+constexpr dword REPLAYS = 100;
+
+/**
+* @param runner benchmark runner.
+* @param name name of the benchmark.
+* @param trace trace of SpiTraceRecorder::snapshot.
+* @brief Replay trace against MockSpi at full speed. Reports host throughput and frames per replay, then bytes per second on device time
+* of mock (@c /device) and on recorder's clock (@c /recorded), so replayed workload is compared with the captured one.
+*/
+void benchReplay(BenchRunner& runner, const std::string& name, std::span<const byte> trace) {
+    MockSpi lab;
+    lab.setWriteCycleTime(std::chrono::microseconds{0});
+    runner.runBench(name, REPLAYS, [&] {
+        if (const Result<SpiTraceStats> result = replaySpiTrace(trace, &lab); !result)
+            throwError(result.error(), "replaySpiTrace()");
+    }, [&] { return lab.getBusStats().transactions; });
+
+    lab.resetBusStats();
+    const Result<SpiTraceStats> stats = replaySpiTrace(trace, &lab);
+    if (!stats)
+        return;
+    runner.reportThroughput(name + "/device", stats.value().bytes, lab.getElapsedTime());
+    runner.reportThroughput(name + "/recorded", stats.value().bytes, stats.value().recorded);
+}
+
+/**
+* @brief Entry point to programm.
+*/
+int main(int argc, char** argv) {
+    BenchRunner::Format format = BenchRunner::FORMAT_TEXT;
+    std::string filter;
+    std::string replay;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--format=json"))
+            format = BenchRunner::FORMAT_JSON;
+        else if (!std::strcmp(argv[i], "--format=csv"))
+            format = BenchRunner::FORMAT_CSV;
+        else if (!std::strcmp(argv[i], "--format=text"))
+            format = BenchRunner::FORMAT_TEXT;
+        else if (!std::strncmp(argv[i], "--filter=", 9))
+            filter = argv[i] + 9;
+        else if (!std::strncmp(argv[i], "--replay=", 9))
+            replay = argv[i] + 9;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--format=text|json|csv] [--filter=substring] [--replay=trace]" << std::endl;
+            return 1;
+        }
+    }
+
+    BenchRunner runner(format, filter);
+    if (!replay.empty()) {
+        std::ifstream file(replay, std::ios::binary);
+        if (!file) {
+            std::cerr << "Trace is not opened: " << replay << std::endl;
+            return 1;
+        }
+        const std::vector<byte> trace{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        benchReplay(runner, "Replay/" + replay, trace);
+        runner.print();
+        return 0;
+    }
+
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    EEPROM_25LC040A eeprom(&spi);
+    const auto transactions = [&] { return spi.getBusStats().transactions; };
+
+    // Random addresses are precomputed, so rand() is not measured
+    pointer_size addresses[RANDOM_ADDRESSES];
+    std::srand(42);
+    for (dword i = 0; i < RANDOM_ADDRESSES; ++i)
+        addresses[i] = std::rand() % (EEPROM_25LC040A::MAX_ADDRESS + 1);
+    dword step = 0;
+
+    // === READ benchmarks: allocating API vs caller provided buffers
+    runner.runBench("ReadBit", ITERATIONS, [&] {
+        doNotOptimize(eeprom.readBit(0));
+    }, transactions);
+    runner.runBench("ReadByte", ITERATIONS, [&] {
+        doNotOptimize(eeprom.readByte(0));
+    }, transactions);
+    for (const array_size length : {1, 16, 64, 256, 512}) {
+        runner.runBench("ReadByteArray/" + std::to_string(length), ITERATIONS, [&] {
+            delete[] eeprom.readByteArray(0, length);
+        }, transactions);
+        runner.runBench("ReadInto/" + std::to_string(length), ITERATIONS, [&] {
+            byte buffer[EEPROM_25LC040A::MAX_ADDRESS + 1];
+            eeprom.readInto(0, std::span<byte>(buffer, length));
+        }, transactions);
+    }
+    runner.runBench("ReadBits/12", ITERATIONS, [&] {
+        bit values[12];
+        eeprom.readBits(bit_index{5}, values);
+    }, transactions);
+
+    // === VECTORED benchmarks: dozen scattered fields of startup configuration, one frame per field vs merged runs
+    byte fields[12][4];
+    const pointer_size FIELD_ADDRESSES[12] = {0, 6, 12, 16, 40, 44, 52, 130, 136, 300, 306, 480};
+    EEPROM_25xx::ReadSegment fieldReads[12];
+    for (byte i = 0; i < 12; ++i)
+        fieldReads[i] = {FIELD_ADDRESSES[11 - i], fields[i]};
+    runner.runBench("Fields x12/readInto", ITERATIONS / 10, [&] {
+        for (const EEPROM_25xx::ReadSegment& field : fieldReads)
+            eeprom.readInto(field.address, field.buffer);
+    }, transactions);
+    runner.runBench("Fields x12/readv", ITERATIONS / 10, [&] {
+        eeprom.readv(fieldReads);
+    }, transactions);
+
+    // === ACCESS PATTERN benchmarks: sequential vs random addresses
+    runner.runBench("ReadByte/sequential", ITERATIONS, [&] {
+        doNotOptimize(eeprom.readByte(step++ % (EEPROM_25LC040A::MAX_ADDRESS + 1)));
+    }, transactions);
+    runner.runBench("ReadByte/random", ITERATIONS, [&] {
+        doNotOptimize(eeprom.readByte(addresses[step++ % RANDOM_ADDRESSES]));
+    }, transactions);
+    runner.runBench("WriteByte/sequential", ITERATIONS, [&] {
+        eeprom.writeByte(step % (EEPROM_25LC040A::MAX_ADDRESS + 1), step);
+        ++step;
+    }, transactions);
+    runner.runBench("WriteByte/random", ITERATIONS, [&] {
+        eeprom.writeByte(addresses[step % RANDOM_ADDRESSES], step);
+        ++step;
+    }, transactions);
+
+    // === DISPATCH benchmarks: type-erased driver vs driver bound to MockSpi at compile time
+    BasicEEPROM_25LC040A<MockSpi> direct(&spi);
+    runner.runBench("ReadByte/virtual", ITERATIONS, [&] {
+        doNotOptimize(eeprom.readByte(0));
+    }, transactions);
+    runner.runBench("ReadByte/direct", ITERATIONS, [&] {
+        doNotOptimize(direct.readByte(0));
+    }, transactions);
+    runner.runBench("WriteByte/virtual", ITERATIONS, [&] {
+        eeprom.writeByte(0, 0x5A);
+    }, transactions);
+    runner.runBench("WriteByte/direct", ITERATIONS, [&] {
+        direct.writeByte(0, 0x5A);
+    }, transactions);
+
+    // === RESULT benchmarks: exception-free API vs throwing API on success and on error path
+    runner.runBench("ReadByte/try", ITERATIONS, [&] {
+        doNotOptimize(eeprom.tryReadByte(0).valueOr(0));
+    }, transactions);
+    runner.runBench("ReadByte/throwing", ITERATIONS, [&] {
+        doNotOptimize(eeprom.readByte(0));
+    }, transactions);
+    runner.runBench("Error/out of range/try", ITERATIONS, [&] {
+        doNotOptimize(eeprom.tryReadByte(EEPROM_25LC040A::MAX_ADDRESS + 1).error());
+    });
+    runner.runBench("Error/out of range/throwing", ITERATIONS, [&] {
+        try {
+            doNotOptimize(eeprom.readByte(EEPROM_25LC040A::MAX_ADDRESS + 1));
+        } catch (const std::out_of_range&) {
+        }
+    });
+
+    // === STATS benchmarks: driver with statistics policy vs the one where it is compiled out
+    InstrumentedEEPROM_25LC040A instrumented(&spi);
+    runner.runBench("ReadByte/stats", ITERATIONS, [&] {
+        doNotOptimize(instrumented.readByte(0));
+    }, transactions);
+    runner.runBench("WriteByte/stats", ITERATIONS, [&] {
+        instrumented.writeByte(0, 0x5A);
+    }, transactions);
+    runner.runBench("StatsSnapshot", ITERATIONS, [&] {
+        doNotOptimize(instrumented.getStats().snapshot().operations[OP_READ_BYTE].calls);
+    });
+
+    // === WRITE benchmarks: read-modify-write of bits, page bursts, compare-before-write when nothing is changed
+    bit toggle = false;
+    runner.runBench("WriteBit", ITERATIONS, [&] {
+        eeprom.writeBit(0, toggle = !toggle);
+    }, transactions);
+    runner.runBench("WriteBits/12", ITERATIONS, [&] {
+        const bit values[12] = {toggle = !toggle, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1};
+        eeprom.writeBits(bit_index{5}, values);
+    }, transactions);
+    byte image[EEPROM_25LC040A::MAX_ADDRESS + 1]{};
+    for (const array_size length : {16, 64, 512}) {
+        runner.runBench("WriteByteArray/" + std::to_string(length), ITERATIONS / 10, [&] {
+            eeprom.writeByteArray(0, image, length);
+        }, transactions);
+    }
+    runner.runBench("WriteByteArray/512 skip unchanged", ITERATIONS / 10, [&] {
+        eeprom.writeByteArray(0, image, sizeof(image), EEPROM_25LC040A::WRITE_SKIP_UNCHANGED);
+    }, transactions);
+
+    // === CACHE benchmarks: reads and writes are memory accesses
+    EEPROM_25LC040A_Cache cache(&eeprom);
+    runner.runBench("CacheReadByte", ITERATIONS, [&] {
+        doNotOptimize(cache.readByte(0));
+    }, transactions);
+    byte counter = 0;
+    runner.runBench("CacheWriteByte", ITERATIONS, [&] {
+        cache.writeByte(0, ++counter);
+    }, transactions);
+    runner.runBench("CacheFlush/1 page", ITERATIONS / 100, [&] {
+        cache.writeByte(0, ++counter);
+        cache.flush();
+    }, transactions);
+
+    // === STREAM benchmarks: characters are buffered, device is accessed once per page
+    EEPROM_25LC040A_Stream stream(&eeprom);
+    runner.runBench("StreamPut", ITERATIONS, [&] {
+        if (!stream.put(++counter))
+            stream.clear(), stream.seekp(0);
+    }, transactions);
+    stream.seekg(0);
+    runner.runBench("StreamGet", ITERATIONS, [&] {
+        doNotOptimize(stream.get());
+        if (!stream)
+            stream.clear(), stream.seekg(0);
+    }, transactions);
+
+    // === ASYNC benchmarks: write followed by CPU work as long as write cycle, work overlaps write cycle in asynchronous API
+    if (runner.selected("WriteByte+work")) {
+        MockSpi slow;
+        slow.setWriteCycleTime(std::chrono::microseconds{100});
+        EEPROM_25LC040A device(&slow);
+        const auto work = [] {
+            const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds{100};
+            while (std::chrono::steady_clock::now() < end);
+        };
+        runner.runBench("WriteByte+work/sync", ITERATIONS / 100, [&] {
+            device.writeByte(0, ++step);
+            work();
+        }, [&] { return slow.getBusStats().transactions; });
+        runner.runBench("WriteByte+work/async", ITERATIONS / 100, [&] {
+            const byte value = ++step;
+            device.writeAsync(0, std::span<const byte>(&value, 1));
+            work();
+        }, [&] { return slow.getBusStats().transactions; });
+    }
+
+    // === DEVICE TIME benchmarks: bytes per simulated second of driver APIs on cost model of mock
+    const auto measure = [&](const std::string& name, auto func) {
+        spi.resetBusStats();
+        func();
+        const dword data = spi.getBusStats(EEPROM_25xx::CMD_READ).payload + spi.getBusStats(EEPROM_25xx::CMD_WRITE).payload;
+        runner.reportThroughput(name, data, spi.getElapsedTime());
+    };
+    measure("Device/ReadByte x512", [&] {
+        for (pointer_size i = 0; i <= EEPROM_25LC040A::MAX_ADDRESS; ++i)
+            doNotOptimize(eeprom.readByte(i));
+    });
+    measure("Device/ReadInto/512", [&] {
+        byte buffer[EEPROM_25LC040A::MAX_ADDRESS + 1];
+        eeprom.readInto(0, buffer);
+    });
+    measure("Device/Fields x12/readInto", [&] {
+        for (const EEPROM_25xx::ReadSegment& field : fieldReads)
+            eeprom.readInto(field.address, field.buffer);
+    });
+    measure("Device/Fields x12/readv", [&] {
+        eeprom.readv(fieldReads);
+    });
+    EEPROM_25xx::WriteSegment fieldWrites[12];
+    for (byte i = 0; i < 12; ++i)
+        fieldWrites[i] = {fieldReads[i].address, fields[i]};
+    measure("Device/Fields x12/writeByteArray", [&] {
+        for (byte i = 0; i < 12; ++i)
+            eeprom.writeByteArray(fieldReads[i].address, fields[i], sizeof(fields[i]));
+    });
+    measure("Device/Fields x12/writev", [&] {
+        eeprom.writev(fieldWrites);
+    });
+    measure("Device/WriteByte x32", [&] {
+        for (pointer_size i = 0; i < 32; ++i)
+            eeprom.writeByte(i, i);
+    });
+    measure("Device/WriteByteArray/512", [&] {
+        eeprom.writeByteArray(0, image, sizeof(image));
+    });
+
+    // === NOR FLASH benchmarks: full chip program throughput on virtual clock of mock
+    if (runner.selected("NorProgram/full chip") || runner.selected("NorErase/full chip") || runner.selected("NorFastRead/full chip")) {
+        MockNorFlash nor;
+        NorFlash flash(&nor, MockNorFlash::DEFAULT_CAPACITY);
+        static byte chip[MockNorFlash::DEFAULT_CAPACITY];
+        for (dword i = 0; i < MockNorFlash::DEFAULT_CAPACITY; ++i)
+            chip[i] = i * 31;
+        auto start = nor.getElapsedTime();
+        flash.program(0, chip);
+        runner.reportThroughput("NorProgram/full chip", MockNorFlash::DEFAULT_CAPACITY, nor.getElapsedTime() - start);
+        start = nor.getElapsedTime();
+        flash.erase(0, MockNorFlash::DEFAULT_CAPACITY);
+        runner.reportThroughput("NorErase/full chip", MockNorFlash::DEFAULT_CAPACITY, nor.getElapsedTime() - start);
+        start = nor.getElapsedTime();
+        flash.readInto(0, chip);
+        runner.reportThroughput("NorFastRead/full chip", MockNorFlash::DEFAULT_CAPACITY, nor.getElapsedTime() - start);
+    }
+
+    // === SHARED BUS benchmarks: threads with own chips on one bus, single-transfer frames are batched by arbiter
+    for (const dword count : {1, 2, 4}) {
+        MockSpi chips[4];
+        MockSpiBus wires({&chips[0], &chips[1], &chips[2], &chips[3]});
+        SpiBus bus(&wires);
+        SpiBus::Device devices[4] = {{bus, wires.line(0)}, {bus, wires.line(1)}, {bus, wires.line(2)}, {bus, wires.line(3)}};
+        runner.runBench("Bus/ReadByte x" + std::to_string(BUS_READS) + "/" + std::to_string(count) + " threads", ITERATIONS / BUS_READS, [&] {
+            std::thread threads[4];
+            for (dword i = 0; i < count; ++i) {
+                threads[i] = std::thread([&, i] {
+                    EEPROM_25LC040A chip(&devices[i]);
+                    for (dword j = 0; j < BUS_READS; ++j)
+                        doNotOptimize(chip.readByte(j % (EEPROM_25LC040A::MAX_ADDRESS + 1)));
+                });
+            }
+            for (dword i = 0; i < count; ++i)
+                threads[i].join();
+        }, [&] { return bus.getFrameCount(); });
+    }
+
+    // === SCHEDULER benchmarks: client threads write interleaved fields and wait for each write on device with real write cycle,
+    // scheduler coalesces writes queued meanwhile by page vs threads sharing driver under mutex
+    for (const dword count : {1, 2, 4, 8}) {
+        const std::string suffix = "Write x" + std::to_string(CLIENT_WRITES) + "/" + std::to_string(count) + " threads";
+        if (!runner.selected("Scheduler/" + suffix) && !runner.selected("Mutex/" + suffix))
+            continue;
+
+        MockSpi chip;
+        chip.setWriteCycleTime(std::chrono::microseconds{100});
+        EEPROM_25LC040A device(&chip);
+        const auto frames = [&] { return chip.getBusStats().transactions; };
+        const auto clients = [&](auto write) {
+            std::thread threads[8];
+            for (dword i = 0; i < count; ++i) {
+                threads[i] = std::thread([&, i] {
+                    for (dword j = 0; j < CLIENT_WRITES; ++j) {
+                        const byte data[4] = {static_cast<byte>(i), static_cast<byte>(j), 0, 0};
+                        write((j * 32 + i * 4) % (EEPROM_25LC040A::MAX_ADDRESS + 1), data);
+                    }
+                });
+            }
+            for (dword i = 0; i < count; ++i)
+                threads[i].join();
+        };
+        const auto deviceTime = [&](const std::string& name, auto write) {
+            chip.resetBusStats();
+            clients(write);
+            runner.reportThroughput("Device/" + name, count * CLIENT_WRITES * 4, chip.getElapsedTime());
+        };
+
+        {
+            EEPROM_25LC040A_Scheduler scheduler(&device);
+            const auto write = [&](const_type<pointer_size> address, std::span<const byte> data) {
+                doNotOptimize(scheduler.write(address, data).get().ok());
+            };
+            runner.runBench("Scheduler/" + suffix, ITERATIONS / 10000, [&] {
+                clients(write);
+            }, frames);
+            deviceTime("Scheduler/" + suffix, write);
+        }
+
+        std::mutex shared;
+        const auto write = [&](const_type<pointer_size> address, std::span<const byte> data) {
+            std::lock_guard<std::mutex> guard(shared);
+            device.writeByteArray(address, const_cast<byte*>(data.data()), data.size());
+        };
+        runner.runBench("Mutex/" + suffix, ITERATIONS / 10000, [&] {
+            clients(write);
+        }, frames);
+        deviceTime("Mutex/" + suffix, write);
+    }
+
+    // === BIT-BANG benchmarks: pin-level device, edges per byte show cost of inner loop on GPIO
+    {
+        MockSpi chip;
+        chip.setWriteCycleTime(std::chrono::microseconds{0});
+        MockSpiPins pins(&chip);
+        BasicSpiBitBang<MockSpiPins> direct(&pins);
+        BasicEEPROM_25LC040A<BasicSpiBitBang<MockSpiPins>> bound(&direct);
+        SpiBitBang virtualPins(&pins);
+        EEPROM_25LC040A runtime(&virtualPins);
+        const auto frames = [&] { return chip.getBusStats().transactions; };
+        byte buffer[EEPROM_25LC040A::MAX_ADDRESS + 1];
+
+        runner.runBench("BitBang/ReadInto/512/direct", ITERATIONS / 100, [&] {
+            bound.readInto(0, buffer);
+        }, frames);
+        runner.runBench("BitBang/ReadInto/512/virtual", ITERATIONS / 100, [&] {
+            runtime.readInto(0, buffer);
+        }, frames);
+        runner.runBench("BitBang/WriteByteArray/512", ITERATIONS / 1000, [&] {
+            bound.writeByteArray(0, image, sizeof(image));
+        }, frames);
+
+        pins.resetPinStats();
+        bound.readInto(0, buffer);
+        runner.reportEdges("BitBang/ReadInto/512/edges", EEPROM_25LC040A_Traits::INSTRUCTION_SIZE + sizeof(buffer), pins.getEdgeCount());
+        pins.resetPinStats();
+        chip.resetBusStats();
+        bound.writeByteArray(0, image, sizeof(image));
+        runner.reportEdges("BitBang/WriteByteArray/512/edges", chip.getBusStats().clocks / 8, pins.getEdgeCount());
+    }
+
+    // === TRACE benchmarks: cost of recording every call, replay of recorded mixed workload
+    {
+        SpiTraceRecorder recorder(&spi);
+        EEPROM_25LC040A traced(&recorder);
+        runner.runBench("Trace/ReadByte/recorded", ITERATIONS, [&] {
+            doNotOptimize(traced.readByte(0));
+        }, transactions);
+        runner.runBench("Trace/WriteByte/recorded", ITERATIONS, [&] {
+            traced.writeByte(0, 0x5A);
+        }, transactions);
+
+        SpiTraceRecorder workload(&spi, 1024 * 1024);
+        EEPROM_25LC040A captured(&workload);
+        captured.writeByteArray(0, image, sizeof(image));
+        for (dword i = 0; i < 1000; ++i) {
+            doNotOptimize(captured.readByte(addresses[i]));
+        }
+        captured.writeByteArray(0x80, image, 64, EEPROM_25LC040A::WRITE_SKIP_UNCHANGED);
+        byte block[64];
+        for (pointer_size i = 0; i < 8; ++i)
+            captured.readInto(i * 64, block);
+        benchReplay(runner, "Trace/replay/mixed", workload.snapshot());
+    }
+
+    runner.print();
+}
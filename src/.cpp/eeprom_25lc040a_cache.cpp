@@ -0,0 +1,110 @@
+#include "../include/eeprom_25lc040a_cache.h"
+#include <stdexcept>
+
+EEPROM_25LC040A_Cache::EEPROM_25LC040A_Cache(const EEPROM_25LC040A* eeprom) : eeprom(eeprom) {
+    if (!eeprom)
+        throw std::invalid_argument("EEPROM_25LC040A_Cache::EEPROM_25LC040A_Cache(): \"eeprom\" is nullptr");
+
+    reload();
+}
+
+EEPROM_25LC040A_Cache::~EEPROM_25LC040A_Cache() {
+    try {
+        flush();
+    } catch (...) {
+    }
+}
+
+const bit EEPROM_25LC040A_Cache::readBit(const_type<pointer_size> address) const {
+    return readByte(address) >> 7;
+}
+
+const byte EEPROM_25LC040A_Cache::readByte(const_type<pointer_size> address) const {
+    if (address > EEPROM_25LC040A::MAX_ADDRESS)
+        throw std::out_of_range("EEPROM_25LC040A_Cache::readByte(): given \"address\" is bigger than EEPROM_25LC040A::MAX_ADDRESS");
+
+    return mirror[address];
+}
+
+void EEPROM_25LC040A_Cache::readInto(const_type<pointer_size> address, std::span<byte> buffer) const {
+    if (address > EEPROM_25LC040A::MAX_ADDRESS)
+        throw std::out_of_range("EEPROM_25LC040A_Cache::readInto(): given \"address\" is bigger than EEPROM_25LC040A::MAX_ADDRESS");
+
+    for (array_size i = 0; i < buffer.size(); ++i)
+        buffer[i] = mirror[(address + i) % (EEPROM_25LC040A::MAX_ADDRESS + 1)];
+}
+
+void EEPROM_25LC040A_Cache::writeBit(const_type<pointer_size> address, const_type<bit> data) {
+    if (address > EEPROM_25LC040A::MAX_ADDRESS)
+        throw std::out_of_range("EEPROM_25LC040A_Cache::writeBit(): given \"address\" is bigger than EEPROM_25LC040A::MAX_ADDRESS");
+
+    store(address, data << 7 | (mirror[address] & 0x7F));
+}
+
+void EEPROM_25LC040A_Cache::writeByte(const_type<pointer_size> address, const_type<byte> data) {
+    if (address > EEPROM_25LC040A::MAX_ADDRESS)
+        throw std::out_of_range("EEPROM_25LC040A_Cache::writeByte(): given \"address\" is bigger than EEPROM_25LC040A::MAX_ADDRESS");
+
+    store(address, data);
+}
+
+void EEPROM_25LC040A_Cache::writeByteArray(const_type<pointer_size> address, const byte_array data, const_type<array_size> length) {
+    if (!length)
+        throw std::invalid_argument("EEPROM_25LC040A_Cache::writeByteArray(): \"length\" is null");
+    if (!data)
+        throw std::invalid_argument("EEPROM_25LC040A_Cache::writeByteArray(): \"data\" is nullptr");
+    if (address > EEPROM_25LC040A::MAX_ADDRESS)
+        throw std::out_of_range("EEPROM_25LC040A_Cache::writeByteArray(): given \"address\" is bigger than EEPROM_25LC040A::MAX_ADDRESS");
+
+    for (array_size i = 0; i < length; ++i)
+        store((address + i) % (EEPROM_25LC040A::MAX_ADDRESS + 1), data[i]);
+}
+
+pointer_size EEPROM_25LC040A_Cache::flush() {
+    pointer_size written = 0;
+    for (pointer_size page = 0; page < PAGE_COUNT; ++page) {
+        const page_mask bit = page_mask{1} << page;
+        if (!(dirty & bit))
+            continue;
+
+        // Page is aligned, so it is written as single burst
+        const pointer_size address = page * EEPROM_25LC040A::PAGE_SIZE;
+        eeprom->writeByteArray(address, mirror + address, EEPROM_25LC040A::PAGE_SIZE);
+
+        dirty &= ~bit;
+        ++written;
+    }
+    return written;
+}
+
+void EEPROM_25LC040A_Cache::setFlushInterval(const_type<std::chrono::milliseconds> interval) noexcept {
+    flushInterval = interval;
+}
+
+pointer_size EEPROM_25LC040A_Cache::poll() {
+    if (!dirty || flushInterval.count() == 0)
+        return 0;
+    if (std::chrono::steady_clock::now() - dirtySince < flushInterval)
+        return 0;
+
+    return flush();
+}
+
+void EEPROM_25LC040A_Cache::reload() {
+    eeprom->readInto(0, mirror);
+    dirty = 0;
+}
+
+EEPROM_25LC040A_Cache::page_mask EEPROM_25LC040A_Cache::dirtyPages() const noexcept {
+    return dirty;
+}
+
+void EEPROM_25LC040A_Cache::store(const_type<pointer_size> address, const_type<byte> data) noexcept {
+    if (mirror[address] == data)
+        return;
+
+    if (!dirty)
+        dirtySince = std::chrono::steady_clock::now();
+    mirror[address] = data;
+    dirty |= page_mask{1} << address / EEPROM_25LC040A::PAGE_SIZE;
+}
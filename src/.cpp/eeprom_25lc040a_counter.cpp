@@ -0,0 +1,91 @@
+#include "../include/eeprom_25lc040a_counter.h"
+#include <stdexcept>
+
+EEPROM_25LC040A_Counter::EEPROM_25LC040A_Counter(const EEPROM_25LC040A* eeprom, const_type<pointer_size> address, const_type<pointer_size> length)
+    : eeprom(eeprom), address(address), count(length - HEADER_SIZE) {
+    if (!eeprom)
+        throw std::invalid_argument("EEPROM_25LC040A_Counter::EEPROM_25LC040A_Counter(): \"eeprom\" is nullptr");
+    if (length < HEADER_SIZE + 2)
+        throw std::invalid_argument("EEPROM_25LC040A_Counter::EEPROM_25LC040A_Counter(): \"length\" has no room for header and two cells");
+    if (address > EEPROM_25LC040A::MAX_ADDRESS || length > EEPROM_25LC040A::MAX_ADDRESS + 1 - address)
+        throw std::out_of_range("EEPROM_25LC040A_Counter::EEPROM_25LC040A_Counter(): region exceeds device");
+
+    load();
+}
+
+void EEPROM_25LC040A_Counter::load() {
+    byte region[EEPROM_25LC040A::MAX_ADDRESS + 1];
+    eeprom->readInto(address, std::span<byte>(region, HEADER_SIZE + count));
+
+    const dword period = region[0] | region[1] << 8 | region[2] << 16 | dword{region[3]} << 24;
+    byte header[HEADER_SIZE];
+    createHeader(period, header);
+    if (header[4] != region[4]) {
+        reset(0);
+        return;
+    }
+
+    // Cells before position are one lap ahead of the last cell
+    const byte* cells = region + HEADER_SIZE;
+    const byte low = cells[count - 1];
+    pointer_size position = 0;
+    while (cells[position] != low)
+        ++position;
+
+    // Laps are the only value with given low byte in window [period * HEADER_PERIOD - 64; period * HEADER_PERIOD + 192).
+    // Header is written one lap before its period starts, so window covers it too
+    const long long first = static_cast<long long>(period) * HEADER_PERIOD - 64;
+    const long long laps = first + static_cast<byte>(low - first);
+    current = laps * count + position;
+}
+
+dword EEPROM_25LC040A_Counter::value() const noexcept {
+    return current;
+}
+
+dword EEPROM_25LC040A_Counter::increment() {
+    const dword next = current + 1;
+    const pointer_size position = current % count;
+    const dword laps = next / count;
+
+    // The last cell starts new lap: header of new period must be on device before it
+    if (position == count - 1 && laps % HEADER_PERIOD == 0)
+        writeHeader(laps / HEADER_PERIOD);
+
+    const byte cell = current / count + 1;
+    eeprom->writeAsync(address + HEADER_SIZE + position, std::span<const byte>(&cell, 1));
+
+    current = next;
+    return current;
+}
+
+void EEPROM_25LC040A_Counter::reset(const_type<dword> value) {
+    // Whole region is written by page bursts: header and cells of both laps
+    byte region[EEPROM_25LC040A::MAX_ADDRESS + 1];
+    const dword laps = value / count;
+    createHeader(laps / HEADER_PERIOD, region);
+    for (pointer_size i = 0; i < count; ++i)
+        region[HEADER_SIZE + i] = i < value % count ? laps + 1 : laps;
+    eeprom->writeByteArray(address, region, HEADER_SIZE + count);
+
+    current = value;
+}
+
+pointer_size EEPROM_25LC040A_Counter::cells() const noexcept {
+    return count;
+}
+
+void EEPROM_25LC040A_Counter::createHeader(const_type<dword> period, byte* header) noexcept {
+    header[0] = period & 0xFF;
+    header[1] = period >> 8 & 0xFF;
+    header[2] = period >> 16 & 0xFF;
+    header[3] = period >> 24;
+    // Check byte isn't constant for erased region: neither 0x00 nor 0xFF header is valid
+    header[4] = header[0] ^ header[1] ^ header[2] ^ header[3] ^ 0xA5;
+}
+
+void EEPROM_25LC040A_Counter::writeHeader(const_type<dword> period) const {
+    byte header[HEADER_SIZE];
+    createHeader(period, header);
+    eeprom->writeByteArray(address, header, HEADER_SIZE);
+}
@@ -0,0 +1,189 @@
+#include "../include/eeprom_25lc040a_kv_store.h"
+#include <cstring>
+#include <stdexcept>
+
+EEPROM_25LC040A_KvStore::EEPROM_25LC040A_KvStore(const EEPROM_25LC040A* eeprom) : eeprom(eeprom) {
+    if (!eeprom)
+        throw std::invalid_argument("EEPROM_25LC040A_KvStore::EEPROM_25LC040A_KvStore(): \"eeprom\" is nullptr");
+
+    mount();
+}
+
+void EEPROM_25LC040A_KvStore::mount() {
+    byte image[EEPROM_25LC040A::MAX_ADDRESS + 1];
+    eeprom->readInto(0, image);
+
+    // Segment is valid if its header is intact. Of two valid segments the one with the next generation is active
+    const auto valid = [&](const_type<byte> number) {
+        const byte* header = image + number * SEGMENT_SIZE;
+        return header[0] == MAGIC && header[1] == static_cast<byte>(~header[2]);
+    };
+    const bit first = valid(0);
+    const bit second = valid(1);
+    if (!first && !second) {
+        // Fresh device: segment 0 is formatted, log is empty
+        const byte header[HEADER_SIZE] = {MAGIC, 0, 0xFF};
+        eeprom->writeByteArray(0, const_cast<byte_array>(header), HEADER_SIZE);
+        std::memcpy(image, header, HEADER_SIZE);
+        segment = 0;
+    } else if (first && second)
+        segment = static_cast<byte>(image[SEGMENT_SIZE + 1] - image[1]) == 1 ? 1 : 0;
+    else
+        segment = second ? 1 : 0;
+
+    std::memcpy(mirror, image + segment * SEGMENT_SIZE, SEGMENT_SIZE);
+    generation = mirror[1];
+
+    // Log ends on the first invalid record. Record which doesn't fit the rest of page is placed on the next page,
+    // so invalid bytes in the middle of page only mean that log continues from the next page
+    std::memset(index, 0, sizeof(index));
+    tail = HEADER_SIZE;
+    pointer_size offset = HEADER_SIZE;
+    while (offset + RECORD_OVERHEAD <= SEGMENT_SIZE) {
+        if (isRecord(mirror, offset, generation)) {
+            index[mirror[offset]] = mirror[offset + 1] ? offset : 0;
+            offset += RECORD_OVERHEAD + mirror[offset + 1];
+            tail = offset;
+        } else if (offset % EEPROM_25LC040A::PAGE_SIZE)
+            offset += EEPROM_25LC040A::PAGE_SIZE - offset % EEPROM_25LC040A::PAGE_SIZE;
+        else
+            break;
+    }
+}
+
+std::span<const byte> EEPROM_25LC040A_KvStore::get(const_type<byte> key) const noexcept {
+    if (key > MAX_KEY || !index[key])
+        return {};
+
+    return std::span<const byte>(mirror + index[key] + 2, mirror[index[key] + 1]);
+}
+
+bool EEPROM_25LC040A_KvStore::contains(const_type<byte> key) const noexcept {
+    return key <= MAX_KEY && index[key];
+}
+
+void EEPROM_25LC040A_KvStore::put(const_type<byte> key, std::span<const byte> value) {
+    if (key > MAX_KEY)
+        throw std::out_of_range("EEPROM_25LC040A_KvStore::put(): given \"key\" is bigger than EEPROM_25LC040A_KvStore::MAX_KEY");
+    if (value.size() > MAX_VALUE_SIZE)
+        throw std::invalid_argument("EEPROM_25LC040A_KvStore::put(): \"value\" is longer than EEPROM_25LC040A_KvStore::MAX_VALUE_SIZE");
+
+    const std::span<const byte> current = get(key);
+    if (current.size() == value.size() && (value.empty() || !std::memcmp(current.data(), value.data(), value.size())))
+        return;
+
+    append(key, value);
+}
+
+bool EEPROM_25LC040A_KvStore::remove(const_type<byte> key) {
+    if (!contains(key))
+        return false;
+
+    append(key, {});
+    return true;
+}
+
+void EEPROM_25LC040A_KvStore::compact() {
+    compact(MAX_KEY + 1, {});
+}
+
+pointer_size EEPROM_25LC040A_KvStore::size() const noexcept {
+    pointer_size count = 0;
+    for (const pointer_size offset : index)
+        count += offset != 0;
+    return count;
+}
+
+pointer_size EEPROM_25LC040A_KvStore::used() const noexcept {
+    return tail;
+}
+
+bool EEPROM_25LC040A_KvStore::isRecord(const byte* frame, const_type<pointer_size> offset, const_type<byte> generation) noexcept {
+    const byte key = frame[offset];
+    const byte length = frame[offset + 1];
+    if (key > MAX_KEY || length > MAX_VALUE_SIZE || offset % EEPROM_25LC040A::PAGE_SIZE + RECORD_OVERHEAD + length > EEPROM_25LC040A::PAGE_SIZE)
+        return false;
+
+    return frame[offset + 2 + length] == checksum(generation, frame + offset, 2 + length);
+}
+
+pointer_size EEPROM_25LC040A_KvStore::place(byte* frame, const_type<pointer_size> offset, const_type<byte> generation, const_type<byte> key, std::span<const byte> value) noexcept {
+    const pointer_size length = RECORD_OVERHEAD + value.size();
+    pointer_size position = offset;
+    if (position % EEPROM_25LC040A::PAGE_SIZE + length > EEPROM_25LC040A::PAGE_SIZE)
+        position += EEPROM_25LC040A::PAGE_SIZE - position % EEPROM_25LC040A::PAGE_SIZE;
+    if (position + length > SEGMENT_SIZE)
+        return 0;
+
+    frame[position] = key;
+    frame[position + 1] = value.size();
+    if (!value.empty())
+        std::memcpy(frame + position + 2, value.data(), value.size());
+    frame[position + 2 + value.size()] = checksum(generation, frame + position, 2 + value.size());
+
+    return position;
+}
+
+byte EEPROM_25LC040A_KvStore::checksum(const_type<byte> generation, const byte* record, const_type<pointer_size> length) noexcept {
+    // Generation is hashed first, so records left by older generations of segment are not valid
+    byte crc = 0;
+    for (pointer_size i = 0; i <= length; ++i) {
+        crc ^= i ? record[i - 1] : generation;
+        for (byte j = 0; j < 8; ++j)
+            crc = crc & 0x80 ? crc << 1 ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+void EEPROM_25LC040A_KvStore::append(const_type<byte> key, std::span<const byte> value) {
+    // Record is built in scratch image, so mirror is changed only when device is written
+    byte frame[SEGMENT_SIZE];
+    const pointer_size position = place(frame, tail, generation, key, value);
+    if (!position) {
+        compact(key, value);
+        return;
+    }
+
+    const pointer_size length = RECORD_OVERHEAD + value.size();
+    eeprom->writeByteArray(segment * SEGMENT_SIZE + position, frame + position, length);
+
+    std::memcpy(mirror + position, frame + position, length);
+    index[key] = value.empty() ? 0 : position;
+    tail = position + length;
+}
+
+void EEPROM_25LC040A_KvStore::compact(const_type<pointer_size> key, std::span<const byte> value) {
+    // Live records are laid out in image of the other segment first, so nothing is written if they don't fit
+    byte image[SEGMENT_SIZE];
+    std::memset(image, 0xFF, SEGMENT_SIZE);
+    const byte next = generation + 1;
+    image[0] = MAGIC;
+    image[1] = next;
+    image[2] = ~next;
+
+    pointer_size moved[MAX_KEY + 1]{};
+    pointer_size end = HEADER_SIZE;
+    for (pointer_size current = 0; current <= MAX_KEY; ++current) {
+        const std::span<const byte> data = current == key ? value : get(current);
+        if (data.empty())
+            continue;
+
+        const pointer_size position = place(image, end, next, current, data);
+        if (!position)
+            throw std::runtime_error("EEPROM_25LC040A_KvStore::compact(): live records don't fit segment");
+        moved[current] = position;
+        end = position + RECORD_OVERHEAD + data.size();
+    }
+
+    // Header is written last: until then the old segment stays active
+    const pointer_size target = (1 - segment) * SEGMENT_SIZE;
+    if (end > HEADER_SIZE)
+        eeprom->writeByteArray(target + HEADER_SIZE, image + HEADER_SIZE, end - HEADER_SIZE);
+    eeprom->writeByteArray(target, image, HEADER_SIZE);
+
+    std::memcpy(mirror, image, SEGMENT_SIZE);
+    std::memcpy(index, moved, sizeof(index));
+    segment = 1 - segment;
+    generation = next;
+    tail = end;
+}
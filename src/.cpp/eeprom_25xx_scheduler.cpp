@@ -0,0 +1,3 @@
+#include "../include/eeprom_25xx_scheduler.h"
+
+template class BasicEEPROM_25xxScheduler<EEPROM_25LC040A>;
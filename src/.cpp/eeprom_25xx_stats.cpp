@@ -0,0 +1,124 @@
+#include "../include/eeprom_25xx_stats.h"
+#include <bit>
+
+const char* describeOperation(const_type<DriverOperation> operation) noexcept {
+    switch (operation) {
+        case OP_READ_BIT:
+            return "readBit";
+        case OP_READ_BYTE:
+            return "readByte";
+        case OP_READ_INTO:
+            return "readInto";
+        case OP_READ_BITS:
+            return "readBits";
+        case OP_WRITE_BIT:
+            return "writeBit";
+        case OP_WRITE_BYTE:
+            return "writeByte";
+        case OP_WRITE_BYTE_ARRAY:
+            return "writeByteArray";
+        case OP_WRITE_BITS:
+            return "writeBits";
+        case OP_WRITE_ASYNC:
+            return "writeAsync";
+        case OP_READ_STATUS:
+            return "readStatus";
+        case OP_WRITE_STATUS:
+            return "writeStatus";
+        case OP_READV:
+            return "readv";
+        case OP_WRITEV:
+            return "writev";
+        case OP_WRITE_CYCLE:
+            return "writeCycle";
+        default:
+            return "unknown";
+    }
+}
+
+std::chrono::nanoseconds OperationStats::percentile(const double quantile) const noexcept {
+    dword total = 0;
+    for (const dword count : latency)
+        total += count;
+    if (!total)
+        return std::chrono::nanoseconds{0};
+
+    // Bucket i ends at 2^i nanoseconds
+    const double rank = quantile * total;
+    dword seen = 0;
+    for (byte i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += latency[i];
+        if (seen >= rank && latency[i])
+            return std::chrono::nanoseconds{1ll << i};
+    }
+    return std::chrono::nanoseconds{1ll << (LATENCY_BUCKETS - 1)};
+}
+
+DriverStats::Token DriverStats::enter(const_type<DriverOperation> operation) noexcept {
+    const bool counted = !depth || operation == OP_WRITE_CYCLE;
+    if (!depth++)
+        current = operation;
+
+    return {counted ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}, operation, counted};
+}
+
+void DriverStats::leave(const Token& token, const_type<bit> ok, const_type<array_size> bytes) noexcept {
+    if (!--depth)
+        current = OP_COUNT;
+    if (!token.counted)
+        return;
+
+    Counters& counters = operations[token.operation];
+    add(counters.calls);
+    if (ok)
+        add(counters.bytes, bytes);
+    else
+        add(counters.errors);
+
+    // Bucket is bit width of latency: one instruction instead of search
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - token.start).count();
+    const byte bucket = std::bit_width(static_cast<unsigned long long>(elapsed));
+    add(counters.latency[bucket < OperationStats::LATENCY_BUCKETS ? bucket : OperationStats::LATENCY_BUCKETS - 1]);
+}
+
+void DriverStats::instruction(const_type<byte> command) noexcept {
+    add(instructions[command & 0b111]);
+    if (current != OP_COUNT)
+        add(operations[current].transactions);
+}
+
+DriverStatsSnapshot DriverStats::snapshot() const noexcept {
+    DriverStatsSnapshot result;
+    for (byte i = 0; i < OP_COUNT; ++i) {
+        const Counters& counters = operations[i];
+        OperationStats& stats = result.operations[i];
+        stats.calls = counters.calls.load(std::memory_order_relaxed);
+        stats.errors = counters.errors.load(std::memory_order_relaxed);
+        stats.bytes = counters.bytes.load(std::memory_order_relaxed);
+        stats.transactions = counters.transactions.load(std::memory_order_relaxed);
+        for (byte j = 0; j < OperationStats::LATENCY_BUCKETS; ++j)
+            stats.latency[j] = counters.latency[j].load(std::memory_order_relaxed);
+    }
+    for (byte i = 0; i < result.instructions.size(); ++i)
+        result.instructions[i] = instructions[i].load(std::memory_order_relaxed);
+
+    return result;
+}
+
+void DriverStats::reset() noexcept {
+    for (Counters& counters : operations) {
+        counters.calls.store(0, std::memory_order_relaxed);
+        counters.errors.store(0, std::memory_order_relaxed);
+        counters.bytes.store(0, std::memory_order_relaxed);
+        counters.transactions.store(0, std::memory_order_relaxed);
+        for (std::atomic<dword>& count : counters.latency)
+            count.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<dword>& count : instructions)
+        count.store(0, std::memory_order_relaxed);
+}
+
+void DriverStats::add(std::atomic<dword>& counter, const_type<dword> value) noexcept {
+    // Single writer: plain load and store are enough, readers never see torn value
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
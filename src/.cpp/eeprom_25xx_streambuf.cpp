@@ -0,0 +1,4 @@
+#include "../include/eeprom_25xx_streambuf.h"
+
+template class BasicEEPROM_25xxStreambuf<EEPROM_25LC040A>;
+template class BasicEEPROM_25xxStream<EEPROM_25LC040A>;
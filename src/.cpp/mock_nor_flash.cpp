@@ -0,0 +1,245 @@
+#include "../include/mock_nor_flash.h"
+
+#include <algorithm>
+
+MockNorFlash::MockNorFlash(const_type<dword> capacity) : memory(capacity, 0xFF), chipEraseTime(BLOCK_ERASE_TIME * (capacity / NorFlash::BLOCK_SIZE)) {}
+
+MockNorFlash::MockNorFlash(const char* image, const_type<dword> capacity) : memory(image, capacity, 0xFF), chipEraseTime(BLOCK_ERASE_TIME * (capacity / NorFlash::BLOCK_SIZE)) {}
+
+void MockNorFlash::chipSelect() {
+    if (SS == LOW)
+        handle_frame_end();
+    SS = HIGH;
+    idleSince = std::chrono::steady_clock::now();
+}
+
+void MockNorFlash::chipDeselect() {
+    // Device works on pending operation while host waits: idle time counts till operation end, so sleeping and polling drivers see the same
+    if (SS == HIGH && isBusy()) {
+        const std::chrono::nanoseconds idle = std::chrono::steady_clock::now() - idleSince;
+        now = now + idle < busyUntil ? now + idle : busyUntil;
+    }
+    SS = LOW;
+    position = 0;
+    latched = false;
+    frameStatus = TRANSFER_OK;
+    shifted = 0;
+    bits = 0;
+}
+
+bit MockNorFlash::transferBit(const_type<bit> data) noexcept {
+    if (SS == HIGH)
+        return 0;
+
+    // Response byte is ready before its first bit, like shift register of device
+    if (!bits)
+        outgoing = next_byte();
+    const bit response = outgoing >> (7 - bits) & 1;
+    shifted = shifted << 1 | data;
+    if (++bits < 8)
+        return response;
+
+    transfer(std::span<const byte>(&shifted, 1), {});
+    shifted = 0;
+    bits = 0;
+    return response;
+}
+
+byte MockNorFlash::transferByte(const_type<byte> data) noexcept {
+    byte response = 0;
+    transfer(std::span<const byte>(&data, 1), std::span<byte>(&response, 1));
+    return response;
+}
+
+TransferStatus MockNorFlash::transfer(std::span<const byte> tx, std::span<byte> rx) noexcept {
+    if (SS == HIGH)
+        return TRANSFER_INVALID_STATE;
+
+    // Like shift register: byte i is received while byte i is sent
+    const array_size length = tx.size() > rx.size() ? tx.size() : rx.size();
+    for (array_size i = 0; i < length; ++i) {
+        // Data of read frame doesn't depend on sent bytes, so the rest of transfer is copied at once
+        const array_size start = data_start();
+        if (start && position >= start && frameStatus == TRANSFER_OK) {
+            if (i < rx.size())
+                memory.read(address + position - start, rx.subspan(i));
+            position += length - i;
+            break;
+        }
+
+        const byte response = handle_byte(i < tx.size() ? tx[i] : 0);
+        if (i < rx.size())
+            rx[i] = response;
+    }
+    now += byteTime * length;
+
+    return frameStatus;
+}
+
+const byte* MockNorFlash::getByteArrayByAddress(const_type<flash_address> address) const {
+    if (address >= memory.size())
+        return nullptr;
+
+    return memory.data() + address;
+}
+
+void MockNorFlash::setClockPeriod(const_type<std::chrono::nanoseconds> period) noexcept {
+    byteTime = period * 8;
+}
+
+void MockNorFlash::setOperationTimes(const_type<std::chrono::microseconds> pageProgram, const_type<std::chrono::microseconds> sectorErase,
+                                     const_type<std::chrono::microseconds> blockErase, const_type<std::chrono::microseconds> chipErase) noexcept {
+    pageProgramTime = pageProgram;
+    sectorEraseTime = sectorErase;
+    blockEraseTime = blockErase;
+    chipEraseTime = chipErase;
+}
+
+std::chrono::nanoseconds MockNorFlash::getElapsedTime() const noexcept {
+    return now;
+}
+
+dword MockNorFlash::getProgramCount() const noexcept {
+    return programs;
+}
+
+dword MockNorFlash::getEraseCount() const noexcept {
+    return erases;
+}
+
+bool MockNorFlash::isBusy() const noexcept {
+    return now < busyUntil;
+}
+
+byte MockNorFlash::next_byte() const noexcept {
+    if (SS == HIGH || !position || frameStatus != TRANSFER_OK)
+        return 0xFF;
+
+    if (command == NorFlash::CMD_RDSR)
+        return (isBusy() ? NorFlash::SR_WIP : 0) | (writeEnabled ? NorFlash::SR_WEL : 0);
+    const array_size start = data_start();
+    if (start && position >= start)
+        return memory.data()[(address + position - start) % memory.size()];
+    return 0xFF;
+}
+
+array_size MockNorFlash::data_start() const noexcept {
+    switch (command) {
+        case NorFlash::CMD_READ:
+            return 4;
+        case NorFlash::CMD_FAST_READ:
+            return 5;
+        default:
+            return 0;
+    }
+}
+
+byte MockNorFlash::handle_byte(const_type<byte> data) noexcept {
+    const array_size index = position++;
+    if (frameStatus != TRANSFER_OK)
+        return 0xFF;
+
+    // 1st byte: command code
+    if (!index) {
+        command = data;
+        address = 0;
+        if (command != NorFlash::CMD_RDSR && isBusy()) {
+            frameStatus = TRANSFER_DEVICE_BUSY;
+            return 0xFF;
+        }
+        switch (command) {
+            case NorFlash::CMD_READ:
+            case NorFlash::CMD_FAST_READ:
+            case NorFlash::CMD_PAGE_PROGRAM:
+            case NorFlash::CMD_WREN:
+            case NorFlash::CMD_WRDI:
+            case NorFlash::CMD_RDSR:
+            case NorFlash::CMD_SECTOR_ERASE:
+            case NorFlash::CMD_BLOCK_ERASE:
+            case NorFlash::CMD_CHIP_ERASE:
+                return 0xFF;
+            default:
+                frameStatus = TRANSFER_INVALID_INSTRUCTION;
+                return 0xFF;
+        }
+    }
+
+    // STATUS register is clocked out continuously
+    if (command == NorFlash::CMD_RDSR)
+        return (isBusy() ? NorFlash::SR_WIP : 0) | (writeEnabled ? NorFlash::SR_WEL : 0);
+
+    // 2nd - 4th bytes: big-endian address
+    if (index < 4) {
+        address = address << 8 | data;
+        if (index == 3)
+            address %= memory.size();
+        return 0xFF;
+    }
+
+    switch (command) {
+        case NorFlash::CMD_READ:
+            return memory.data()[(address + index - 4) % memory.size()];
+        case NorFlash::CMD_FAST_READ:
+            // 5th byte is dummy
+            return index < 5 ? 0xFF : memory.data()[(address + index - 5) % memory.size()];
+        case NorFlash::CMD_PAGE_PROGRAM:
+            if (!latched) {
+                std::fill(latch, latch + NorFlash::PAGE_SIZE, 0xFF);
+                latched = true;
+            }
+            latch[(address + index - 4) % NorFlash::PAGE_SIZE] = data;
+            return 0xFF;
+        default:
+            return 0xFF;
+    }
+}
+
+void MockNorFlash::handle_frame_end() noexcept {
+    if (frameStatus != TRANSFER_OK || !position)
+        return;
+
+    switch (command) {
+        case NorFlash::CMD_WREN:
+            writeEnabled = true;
+            return;
+        case NorFlash::CMD_WRDI:
+            writeEnabled = false;
+            return;
+        case NorFlash::CMD_PAGE_PROGRAM: {
+            if (!writeEnabled || !latched)
+                return;
+
+            // Programming only clears bits
+            const flash_address page = address - address % NorFlash::PAGE_SIZE;
+            for (array_size i = 0; i < NorFlash::PAGE_SIZE; ++i)
+                memory.data()[page + i] &= latch[i];
+
+            writeEnabled = false;
+            busyUntil = now + pageProgramTime;
+            ++programs;
+            return;
+        }
+        case NorFlash::CMD_SECTOR_ERASE:
+            if (writeEnabled && position >= 4)
+                handle_erase(address - address % NorFlash::SECTOR_SIZE, NorFlash::SECTOR_SIZE, sectorEraseTime);
+            return;
+        case NorFlash::CMD_BLOCK_ERASE:
+            if (writeEnabled && position >= 4)
+                handle_erase(address - address % NorFlash::BLOCK_SIZE, NorFlash::BLOCK_SIZE, blockEraseTime);
+            return;
+        case NorFlash::CMD_CHIP_ERASE:
+            if (writeEnabled)
+                handle_erase(0, memory.size(), chipEraseTime);
+            return;
+        default:
+            return;
+    }
+}
+
+void MockNorFlash::handle_erase(const_type<flash_address> start, const_type<dword> length, const_type<std::chrono::nanoseconds> time) noexcept {
+    std::fill(memory.data() + start, memory.data() + start + length, 0xFF);
+
+    writeEnabled = false;
+    busyUntil = now + time;
+    ++erases;
+}
@@ -0,0 +1,62 @@
+#include "../include/mock_spi_bus.h"
+
+#include <stdexcept>
+
+MockSpiBus::Line::Line(MockSpiBus& bus, ISpiBitBang* chip) noexcept : bus(bus), chip(chip) {}
+
+void MockSpiBus::Line::activate() noexcept {
+    if (bus.selected.exchange(chip) != nullptr)
+        bus.collisions.fetch_add(1, std::memory_order_relaxed);
+    chip->chipDeselect();
+}
+
+void MockSpiBus::Line::deactivate() noexcept {
+    chip->chipSelect();
+    ISpiBitBang* expected = chip;
+    bus.selected.compare_exchange_strong(expected, nullptr);
+}
+
+MockSpiBus::MockSpiBus(std::initializer_list<ISpiBitBang*> chips) {
+    lines.reserve(chips.size());
+    for (ISpiBitBang* chip : chips)
+        lines.emplace_back(*this, chip);
+}
+
+void MockSpiBus::chipSelect() {}
+
+void MockSpiBus::chipDeselect() {}
+
+bit MockSpiBus::transferBit(const_type<bit> data) {
+    ISpiBitBang* chip = selected.load();
+    if (!chip)
+        validateTransferStatus(TRANSFER_INVALID_STATE);
+
+    return chip->transferBit(data);
+}
+
+byte MockSpiBus::transferByte(const_type<byte> data) {
+    ISpiBitBang* chip = selected.load();
+    if (!chip)
+        validateTransferStatus(TRANSFER_INVALID_STATE);
+
+    return chip->transferByte(data);
+}
+
+TransferStatus MockSpiBus::transfer(std::span<const byte> tx, std::span<byte> rx) noexcept {
+    ISpiBitBang* chip = selected.load();
+    if (!chip)
+        return TRANSFER_INVALID_STATE;
+
+    return chip->transfer(tx, rx);
+}
+
+IChipSelect* MockSpiBus::line(const_type<dword> index) {
+    if (index >= lines.size())
+        throw std::out_of_range("MockSpiBus::line(): given \"index\" is bigger than chips count");
+
+    return &lines[index];
+}
+
+dword MockSpiBus::getCollisionCount() const noexcept {
+    return collisions.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,3 @@
+#include "../include/mock_spi_pins.h"
+
+template class BasicMockSpiPins<EEPROM_25LC040A_Traits>;
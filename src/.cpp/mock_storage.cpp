@@ -0,0 +1,99 @@
+#include "../include/mock_storage.h"
+#include "../include/result.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MockStorage::MockStorage(const_type<dword> size, const_type<byte> fill) : length(size) {
+    if (!size)
+        throwError(ERROR_INVALID_ARGUMENT, "MockStorage::MockStorage()");
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+        throwError(ERROR_NO_MEMORY, "MockStorage::MockStorage()");
+    memory = static_cast<byte*>(mapping);
+
+    // Anonymous pages are zeroed by operating system
+    if (fill)
+        std::memset(memory, fill, size);
+}
+
+MockStorage::MockStorage(const char* path, const_type<dword> size, const_type<byte> fill) : length(size) {
+    if (!size)
+        throwError(ERROR_INVALID_ARGUMENT, "MockStorage::MockStorage()");
+    if (!path)
+        throwError(ERROR_INVALID_ARGUMENT, "MockStorage::MockStorage()");
+
+    file = open(path, O_RDWR | O_CREAT, 0644);
+    if (file < 0)
+        throw std::runtime_error("MockStorage::MockStorage(): image is not opened");
+
+    struct stat info;
+    if (fstat(file, &info) || (info.st_size < off_t{size} && ftruncate(file, size))) {
+        close(file);
+        throw std::runtime_error("MockStorage::MockStorage(): image is not resized");
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (mapping == MAP_FAILED) {
+        close(file);
+        throw std::runtime_error("MockStorage::MockStorage(): image is not mapped");
+    }
+    memory = static_cast<byte*>(mapping);
+
+    // Only new tail is filled, existing state is mapped as is
+    if (fill && info.st_size < off_t{size})
+        std::memset(memory + info.st_size, fill, size - info.st_size);
+}
+
+MockStorage::~MockStorage() {
+    munmap(memory, length);
+    if (file >= 0)
+        close(file);
+}
+
+dword MockStorage::size() const noexcept {
+    return length;
+}
+
+byte* MockStorage::data() noexcept {
+    return memory;
+}
+
+const byte* MockStorage::data() const noexcept {
+    return memory;
+}
+
+void MockStorage::read(const_type<dword> address, std::span<byte> buffer) const noexcept {
+    dword position = address % length;
+    array_size done = 0;
+    while (done < buffer.size()) {
+        const array_size chunk = buffer.size() - done < length - position ? buffer.size() - done : length - position;
+        std::memcpy(buffer.data() + done, memory + position, chunk);
+
+        done += chunk;
+        position = 0;
+    }
+}
+
+void MockStorage::write(const_type<dword> address, std::span<const byte> data) noexcept {
+    dword position = address % length;
+    array_size done = 0;
+    while (done < data.size()) {
+        const array_size chunk = data.size() - done < length - position ? data.size() - done : length - position;
+        std::memcpy(memory + position, data.data() + done, chunk);
+
+        done += chunk;
+        position = 0;
+    }
+}
+
+void MockStorage::sync() const {
+    if (file >= 0 && msync(memory, length, MS_SYNC))
+        throw std::runtime_error("MockStorage::sync(): image is not written");
+}
@@ -0,0 +1,200 @@
+#include "../include/nor_flash.h"
+
+#include <stdexcept>
+#include <thread>
+
+NorFlash::NorFlash(ISpiBitBang* spi, const_type<dword> capacity) : spi(spi), size(capacity) {
+    if (!capacity || capacity % BLOCK_SIZE || capacity > MAX_CAPACITY)
+        throw std::invalid_argument("NorFlash::NorFlash(): \"capacity\" must be multiple of NorFlash::BLOCK_SIZE no more than NorFlash::MAX_CAPACITY");
+}
+
+dword NorFlash::capacity() const noexcept {
+    return size;
+}
+
+byte NorFlash::readByte(const_type<flash_address> address) const {
+    byte value;
+    readInto(address, std::span<byte>(&value, 1));
+
+    return value;
+}
+
+void NorFlash::readInto(const_type<flash_address> address, std::span<byte> buffer) const {
+    validateSpi();
+    if (buffer.empty())
+        throw std::invalid_argument("NorFlash::readInto(): \"buffer\" is empty");
+    if (address >= size)
+        throw std::out_of_range("NorFlash::readInto(): given \"address\" is bigger than device capacity");
+
+    // Read order:
+    // 1. Set CS low.
+    // 2. Push CMD_FAST_READ, address and dummy byte.
+    // 3. Clock data chunk by chunk while CS is low: device streams data unless CS is set high.
+    // 4. Set CS high.
+    byte header[HEADER_SIZE + 1]{};
+    createHeader(header, CMD_FAST_READ, address);
+
+    spi->chipDeselect();
+    TransferStatus status = spi->transfer(header, {});
+    for (array_size read = 0; status == TRANSFER_OK && read < buffer.size(); read += STREAM_CHUNK_SIZE) {
+        const array_size chunk = buffer.size() - read < STREAM_CHUNK_SIZE ? buffer.size() - read : STREAM_CHUNK_SIZE;
+        status = spi->transfer({}, buffer.subspan(read, chunk));
+    }
+    spi->chipSelect();
+
+    validateTransferStatus(status);
+}
+
+dword NorFlash::program(const_type<flash_address> address, std::span<const byte> data) const {
+    validateSpi();
+    if (data.empty())
+        throw std::invalid_argument("NorFlash::program(): \"data\" is empty");
+    validateRange(address, data.size());
+
+    // Device wraps address inside page, so data is split into bursts which end on page boundary
+    dword bursts = 0;
+    array_size written = 0;
+    while (written < data.size()) {
+        const flash_address position = address + written;
+        const array_size room = PAGE_SIZE - position % PAGE_SIZE;
+        const array_size chunk = data.size() - written < room ? data.size() - written : room;
+
+        execute(CMD_PAGE_PROGRAM, position, data.subspan(written, chunk), PAGE_PROGRAM_TIME, PAGE_PROGRAM_TIMEOUT);
+
+        written += chunk;
+        ++bursts;
+    }
+    return bursts;
+}
+
+dword NorFlash::erase(const_type<flash_address> address, const_type<dword> length) const {
+    validateSpi();
+    if (!length || address % SECTOR_SIZE || length % SECTOR_SIZE)
+        throw std::invalid_argument("NorFlash::erase(): range must be aligned to NorFlash::SECTOR_SIZE");
+    validateRange(address, length);
+
+    if (!address && length == size) {
+        eraseChip();
+        return 1;
+    }
+
+    // The largest aligned unit which fits the rest of range is used on every step
+    dword instructions = 0;
+    flash_address position = address;
+    const flash_address end = address + length;
+    while (position < end) {
+        if (!(position % BLOCK_SIZE) && end - position >= BLOCK_SIZE) {
+            execute(CMD_BLOCK_ERASE, position, {}, BLOCK_ERASE_TIME, BLOCK_ERASE_TIMEOUT);
+            position += BLOCK_SIZE;
+        } else {
+            execute(CMD_SECTOR_ERASE, position, {}, SECTOR_ERASE_TIME, SECTOR_ERASE_TIMEOUT);
+            position += SECTOR_SIZE;
+        }
+        ++instructions;
+    }
+    return instructions;
+}
+
+void NorFlash::eraseChip() const {
+    validateSpi();
+
+    // 1. Enable writing
+    const byte wren = CMD_WREN;
+    transact(std::span<const byte>(&wren, 1), {});
+
+    // 2. Erase chip. Instruction has no address
+    const byte erase = CMD_CHIP_ERASE;
+    transact(std::span<const byte>(&erase, 1), {});
+
+    // 3. Wait for erase completion
+    waitReady(BLOCK_ERASE_TIME * (size / BLOCK_SIZE), CHIP_ERASE_TIMEOUT);
+}
+
+byte NorFlash::readStatus() const {
+    validateSpi();
+
+    // STATUS register is received right after command code
+    byte arr[2] = {CMD_RDSR, 0};
+    transact(std::span<const byte>(arr, 1), arr);
+
+    return arr[1];
+}
+
+bool NorFlash::isBusy() const {
+    return readStatus() & SR_WIP;
+}
+
+inline void NorFlash::validateSpi() const {
+    if (!spi)
+        throw std::runtime_error("NorFlash::validateSpi(): \"spi\" is nullptr");
+}
+
+inline void NorFlash::validateRange(const_type<flash_address> address, const_type<dword> length) const {
+    if (address >= size || length > size - address)
+        throw std::out_of_range("NorFlash::validateRange(): range exceeds device capacity");
+}
+
+inline void NorFlash::createHeader(byte* frame, const_type<Command> cmd, const_type<flash_address> address) noexcept {
+    frame[0] = cmd;
+    frame[1] = (address & 0xFF0000) >> 16;
+    frame[2] = (address & 0x00FF00) >> 8;
+    frame[3] = address & 0x0000FF;
+}
+
+void NorFlash::execute(const_type<Command> cmd, const_type<flash_address> address, std::span<const byte> data, const_type<std::chrono::microseconds> expected,
+                       const_type<std::chrono::microseconds> timeout) const {
+    // Execute order:
+    // 1. Push CMD_WREN instruction. WEL is latched when CS is set high.
+    // 2. Push instruction with address and data. Device starts operation when CS is set high.
+    // 3. Poll STATUS register unless WIP is cleared. WEL is reset by device after operation.
+
+    // 1. Enable writing
+    const byte wren = CMD_WREN;
+    transact(std::span<const byte>(&wren, 1), {});
+
+    // 2. Header and data are sent in the same frame
+    byte header[HEADER_SIZE];
+    createHeader(header, cmd, address);
+
+    spi->chipDeselect();
+    TransferStatus status = spi->transfer(header, {});
+    if (status == TRANSFER_OK && !data.empty())
+        status = spi->transfer(data, {});
+    spi->chipSelect();
+    validateTransferStatus(status);
+
+    // 3. Wait for completion
+    waitReady(expected, timeout);
+}
+
+void NorFlash::waitReady(const_type<std::chrono::microseconds> expected, const_type<std::chrono::microseconds> timeout) const {
+    using namespace std::chrono;
+    const steady_clock::time_point start = steady_clock::now();
+    const steady_clock::time_point deadline = start + timeout;
+
+    // 1. Quick polls: operation may be shorter than expected or already overlapped by caller's work
+    for (byte i = 0; i < QUICK_POLLS; ++i)
+        if (!isBusy())
+            return;
+
+    // 2. Sleep till half of expected time, then poll with doubling interval starting from 1/16 of it
+    const microseconds limit = expected / 4 > POLL_INTERVAL_MIN ? expected / 4 : POLL_INTERVAL_MIN;
+    microseconds interval = expected / 16 > POLL_INTERVAL_MIN ? expected / 16 : POLL_INTERVAL_MIN;
+    steady_clock::time_point wake = start + expected / 2;
+    for (;;) {
+        if (steady_clock::now() < wake)
+            std::this_thread::sleep_until(wake);
+        if (!isBusy())
+            return;
+
+        const steady_clock::time_point now = steady_clock::now();
+        if (now > deadline)
+            throw std::runtime_error("NorFlash::waitReady(): operation timeout");
+        wake = now + interval;
+        interval = interval * 2 < limit ? interval * 2 : limit;
+    }
+}
+
+void NorFlash::transact(std::span<const byte> tx, std::span<byte> rx) const {
+    validateTransferStatus(spi->transact(tx, rx));
+}
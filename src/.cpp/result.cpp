@@ -0,0 +1,50 @@
+#include "../include/result.h"
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+const char* describeError(const_type<ErrorCode> error) noexcept {
+    switch (error) {
+        case ERROR_NONE:
+            return "no error";
+        case ERROR_INVALID_ARGUMENT:
+            return "invalid argument is provided";
+        case ERROR_OUT_OF_RANGE:
+            return "address is out of range";
+        case ERROR_NO_BACKEND:
+            return "\"spi\" is nullptr";
+        case ERROR_STOPPED:
+            return "device isn't working";
+        case ERROR_TIMEOUT:
+            return "write cycle timeout";
+        case ERROR_NO_MEMORY:
+            return "not enough memory";
+        case ERROR_INVALID_STATE:
+            return "device is not selected";
+        case ERROR_DEVICE_BUSY:
+            return "write cycle is in progress";
+        case ERROR_INVALID_INSTRUCTION:
+            return "invalid instruction is provided";
+        default:
+            return "unknown error";
+    }
+}
+
+void throwError(const_type<ErrorCode> error, const char* where) {
+#if defined(__cpp_exceptions)
+    const std::string message = std::string(where) + ": " + describeError(error);
+    switch (error) {
+        case ERROR_INVALID_ARGUMENT:
+            throw std::invalid_argument(message);
+        case ERROR_OUT_OF_RANGE:
+            throw std::out_of_range(message);
+        case ERROR_NO_MEMORY:
+            throw std::bad_alloc();
+        default:
+            throw std::runtime_error(message);
+    }
+#else
+    std::abort();
+#endif
+}
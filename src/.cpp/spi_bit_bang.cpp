@@ -0,0 +1,3 @@
+#include "../include/spi_bit_bang.h"
+
+template class BasicSpiBitBang<IGpioPins>;
@@ -0,0 +1,124 @@
+#include "../include/spi_bus.h"
+
+SpiBus::Device::Device(SpiBus& bus, IChipSelect* line) noexcept : bus(bus), line(line) {}
+
+void SpiBus::Device::chipSelect() {
+    if (!owner)
+        return;
+
+    line->deactivate();
+    bus.frames.fetch_add(1, std::memory_order_relaxed);
+
+    // Frames queued while this frame was on the wire don't wait for the next owner
+    bus.drain();
+    owner = false;
+    bus.release();
+}
+
+void SpiBus::Device::chipDeselect() {
+    if (!owner) {
+        bus.acquire();
+        owner = true;
+    }
+    line->activate();
+}
+
+bit SpiBus::Device::transferBit(const_type<bit> data) {
+    if (!owner)
+        validateTransferStatus(TRANSFER_INVALID_STATE);
+
+    return bus.backend->transferBit(data);
+}
+
+byte SpiBus::Device::transferByte(const_type<byte> data) {
+    if (!owner)
+        validateTransferStatus(TRANSFER_INVALID_STATE);
+
+    return bus.backend->transferByte(data);
+}
+
+TransferStatus SpiBus::Device::transfer(std::span<const byte> tx, std::span<byte> rx) noexcept {
+    if (!owner)
+        return TRANSFER_INVALID_STATE;
+
+    return bus.backend->transfer(tx, rx);
+}
+
+TransferStatus SpiBus::Device::transact(std::span<const byte> tx, std::span<byte> rx) noexcept {
+    // Bus is already owned by frame started by chipDeselect: waiting for it would never end
+    if (owner)
+        return TRANSFER_INVALID_STATE;
+
+    Request request{line, tx, rx};
+    bus.submit(request);
+
+    return request.status;
+}
+
+SpiBus::SpiBus(ISpiBitBang* backend) noexcept : backend(backend) {}
+
+dword SpiBus::getFrameCount() const noexcept {
+    return frames.load(std::memory_order_relaxed);
+}
+
+dword SpiBus::getBatchCount() const noexcept {
+    return batches.load(std::memory_order_relaxed);
+}
+
+void SpiBus::submit(Request& request) noexcept {
+    request.next = pending.load(std::memory_order_relaxed);
+    while (!pending.compare_exchange_weak(request.next, &request, std::memory_order_release, std::memory_order_relaxed));
+
+    // Whoever owns the bus next executes the request: either this thread or current owner before release.
+    // Owner always drains before release, so waking on release is enough to see request done
+    while (!request.done.load(std::memory_order_acquire)) {
+        if (!owned.exchange(true, std::memory_order_acquire)) {
+            drain();
+            release();
+        } else
+            owned.wait(true, std::memory_order_relaxed);
+    }
+}
+
+void SpiBus::acquire() noexcept {
+    while (owned.exchange(true, std::memory_order_acquire))
+        owned.wait(true, std::memory_order_relaxed);
+}
+
+void SpiBus::release() noexcept {
+    owned.store(false, std::memory_order_release);
+    owned.notify_all();
+}
+
+void SpiBus::drain() noexcept {
+    Request* stack = pending.exchange(nullptr, std::memory_order_acquire);
+    if (!stack)
+        return;
+
+    // Stack is LIFO, so it is reversed to keep arrival order
+    Request* queue = nullptr;
+    while (stack) {
+        Request* next = stack->next;
+        stack->next = queue;
+        queue = stack;
+        stack = next;
+    }
+
+    batches.fetch_add(1, std::memory_order_relaxed);
+    while (queue) {
+        // Request is destroyed by its thread as soon as it is done, so link is read before
+        Request* next = queue->next;
+        queue->status = execute(queue->line, queue->tx, queue->rx);
+        queue->done.store(true, std::memory_order_release);
+        queue = next;
+    }
+}
+
+TransferStatus SpiBus::execute(IChipSelect* line, std::span<const byte> tx, std::span<byte> rx) noexcept {
+    line->activate();
+    const TransferStatus status = backend->transfer(tx, rx);
+    line->deactivate();
+    frames.fetch_add(1, std::memory_order_relaxed);
+
+    return status;
+}
@@ -0,0 +1,28 @@
+#include "../include/spi_interface.h"
+#include "../include/result.h"
+
+void validateTransferStatus(const_type<TransferStatus> status) {
+    if (status != TRANSFER_OK)
+        throwError(toErrorCode(status), "ISpiBitBang::transfer");
+}
+
+byte_array ISpiBitBang::transferBytes(const byte_array data, const_type<array_size> length) {
+    if (!data)
+        throwError(ERROR_INVALID_ARGUMENT, "ISpiBitBang::transferBytes");
+
+    byte_array response = new byte[length];
+    const TransferStatus status = transfer(std::span<const byte>(data, length), std::span<byte>(response, length));
+    if (status != TRANSFER_OK) {
+        delete[] response;
+        validateTransferStatus(status);
+    }
+    return response;
+}
+
+TransferStatus ISpiBitBang::transact(std::span<const byte> tx, std::span<byte> rx) noexcept {
+    chipDeselect();
+    const TransferStatus status = transfer(tx, rx);
+    chipSelect();
+
+    return status;
+}
@@ -0,0 +1,242 @@
+#include "../include/spi_trace.h"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+SpiTraceRecorder::SpiTraceRecorder(ISpiBitBang* spi, const_type<array_size> capacity) : spi(spi), last(std::chrono::steady_clock::now()) {
+    if (!spi)
+        throw std::invalid_argument("SpiTraceRecorder::SpiTraceRecorder(): \"spi\" is nullptr");
+
+    const array_size size = std::bit_ceil(capacity > MAX_RECORD_HEADER + 5 ? capacity : array_size{MAX_RECORD_HEADER + 5});
+    buffer = std::make_unique<byte[]>(size);
+    mask = size - 1;
+}
+
+void SpiTraceRecorder::chipSelect() {
+    record(TRACE_CHIP_SELECT, std::chrono::steady_clock::now());
+    spi->chipSelect();
+}
+
+void SpiTraceRecorder::chipDeselect() {
+    record(TRACE_CHIP_DESELECT, std::chrono::steady_clock::now());
+    spi->chipDeselect();
+}
+
+bit SpiTraceRecorder::transferBit(const_type<bit> data) {
+    record(TRACE_BIT | (data ? 0x80 : 0), last);
+    return spi->transferBit(data);
+}
+
+byte SpiTraceRecorder::transferByte(const_type<byte> data) {
+    record(TRACE_TRANSFER, last, std::span<const byte>(&data, 1), 1);
+    return spi->transferByte(data);
+}
+
+TransferStatus SpiTraceRecorder::transfer(std::span<const byte> tx, std::span<byte> rx) noexcept {
+    record(TRACE_TRANSFER, last, tx, rx.size());
+    return spi->transfer(tx, rx);
+}
+
+TransferStatus SpiTraceRecorder::transact(std::span<const byte> tx, std::span<byte> rx) noexcept {
+    // Whole frame is executed at once: clock is read once
+    const auto now = std::chrono::steady_clock::now();
+    record(TRACE_CHIP_DESELECT, now);
+    record(TRACE_TRANSFER, now, tx, rx.size());
+    record(TRACE_CHIP_SELECT, now);
+    return spi->transact(tx, rx);
+}
+
+std::vector<byte> SpiTraceRecorder::snapshot() const {
+    std::vector<byte> trace(sizeof(MAGIC) + (head - tail));
+    std::memcpy(trace.data(), MAGIC, sizeof(MAGIC));
+
+    // Records may wrap around the end of buffer: copy is split in two parts at most
+    const array_size from = tail & mask;
+    const array_size first = head - tail < mask + 1 - from ? head - tail : mask + 1 - from;
+    std::memcpy(trace.data() + sizeof(MAGIC), buffer.get() + from, first);
+    std::memcpy(trace.data() + sizeof(MAGIC) + first, buffer.get(), head - tail - first);
+
+    return trace;
+}
+
+dword SpiTraceRecorder::getRecordCount() const noexcept {
+    return records;
+}
+
+dword SpiTraceRecorder::getDroppedCount() const noexcept {
+    return dropped;
+}
+
+void SpiTraceRecorder::clear() noexcept {
+    head = tail = 0;
+    records = dropped = 0;
+    last = std::chrono::steady_clock::now();
+}
+
+void SpiTraceRecorder::record(const_type<byte> event, const std::chrono::steady_clock::time_point now, std::span<const byte> tx, const_type<array_size> rxLength) noexcept {
+    // Small record is encoded on stack and pushed at once, sent bytes of large one are copied straight into buffer
+    byte encoded[MAX_RECORD_HEADER + INLINE_SIZE + 5];
+    byte length = 0;
+    encoded[length++] = event;
+    length += encode_varint((now - last).count(), encoded + length);
+    const bool transfer = (event & 0b11) == TRACE_TRANSFER;
+    const bool inlined = tx.size() <= INLINE_SIZE;
+    byte footer[5];
+    byte footerLength = 0;
+    if (transfer) {
+        length += encode_varint(tx.size(), encoded + length);
+        if (inlined) {
+            std::memcpy(encoded + length, tx.data(), tx.size());
+            length += tx.size();
+            length += encode_varint(rxLength, encoded + length);
+        } else
+            footerLength = encode_varint(rxLength, footer);
+    }
+    const unsigned long long size = length + (inlined ? 0 : tx.size() + footerLength);
+
+    // Record which doesn't fit whole buffer is dropped: trace must stay decodable
+    if (size > mask + 1) {
+        ++dropped;
+        return;
+    }
+    while (mask + 1 - (head - tail) < size) {
+        tail += record_size();
+        --records;
+        ++dropped;
+    }
+
+    push(encoded, length);
+    if (!inlined) {
+        push(tx.data(), tx.size());
+        push(footer, footerLength);
+    }
+    ++records;
+    last = now;
+}
+
+void SpiTraceRecorder::push(const byte* data, const_type<array_size> length) noexcept {
+    const array_size from = head & mask;
+    head += length;
+    if (length <= mask + 1 - from) {
+        std::memcpy(buffer.get() + from, data, length);
+        return;
+    }
+
+    const array_size first = mask + 1 - from;
+    std::memcpy(buffer.get() + from, data, first);
+    std::memcpy(buffer.get(), data + first, length - first);
+}
+
+array_size SpiTraceRecorder::record_size() const noexcept {
+    array_size position = tail;
+    const auto varint = [&] {
+        unsigned long long value = 0;
+        for (byte shift = 0;; shift += 7) {
+            const byte next = buffer[position++ & mask];
+            value |= static_cast<unsigned long long>(next & 0x7F) << shift;
+            if (!(next & 0x80))
+                return value;
+        }
+    };
+
+    const byte event = buffer[position++ & mask];
+    varint();
+    if ((event & 0b11) == TRACE_TRANSFER) {
+        position += varint();
+        varint();
+    }
+    return position - tail;
+}
+
+byte SpiTraceRecorder::encode_varint(unsigned long long value, byte* out) noexcept {
+    byte length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<byte>(value) | 0x80;
+        value >>= 7;
+    }
+    out[length++] = static_cast<byte>(value);
+    return length;
+}
+
+Result<SpiTraceStats> replaySpiTrace(std::span<const byte> trace, ISpiBitBang* spi) {
+    if (!spi)
+        return ERROR_NO_BACKEND;
+    if (trace.size() < sizeof(SpiTraceRecorder::MAGIC) || std::memcmp(trace.data(), SpiTraceRecorder::MAGIC, sizeof(SpiTraceRecorder::MAGIC)))
+        return ERROR_INVALID_ARGUMENT;
+
+    // Varint which ends beyond trace or overflows is malformed
+    std::size_t position = sizeof(SpiTraceRecorder::MAGIC);
+    const auto varint = [&](unsigned long long& value) {
+        value = 0;
+        for (byte shift = 0; position < trace.size() && shift < 64; shift += 7) {
+            const byte next = trace[position++];
+            value |= static_cast<unsigned long long>(next & 0x7F) << shift;
+            if (!(next & 0x80))
+                return true;
+        }
+        return false;
+    };
+
+    SpiTraceStats stats;
+    byte scratch[SpiTraceRecorder::REPLAY_CHUNK_SIZE];
+    bit framed = false;
+    while (position < trace.size()) {
+        const byte header = trace[position++];
+        unsigned long long delta;
+        if (!varint(delta))
+            return ERROR_INVALID_ARGUMENT;
+        stats.recorded += std::chrono::nanoseconds(delta);
+
+        switch (header & 0b11) {
+            case TRACE_CHIP_SELECT:
+                if (framed) {
+                    spi->chipSelect();
+                    ++stats.frames;
+                }
+                break;
+            case TRACE_CHIP_DESELECT:
+                spi->chipDeselect();
+                framed = true;
+                break;
+            case TRACE_BIT:
+                if (!framed)
+                    break;
+                try {
+                    spi->transferBit(header & 0x80);
+                } catch (const std::exception&) {
+                    return ERROR_INVALID_STATE;
+                }
+                ++stats.transfers;
+                break;
+            default: {
+                unsigned long long txLength;
+                if (!varint(txLength) || txLength > trace.size() - position)
+                    return ERROR_INVALID_ARGUMENT;
+                const std::span<const byte> tx = trace.subspan(position, txLength);
+                position += txLength;
+                unsigned long long rxLength;
+                if (!varint(rxLength) || txLength > SpiTraceRecorder::MAX_TRANSFER_SIZE || rxLength > SpiTraceRecorder::MAX_TRANSFER_SIZE)
+                    return ERROR_INVALID_ARGUMENT;
+                if (!framed)
+                    break;
+
+                // Received bytes are dropped: long transfer is clocked by chunks of scratch size, bytes stream is the same
+                const array_size length = txLength > rxLength ? txLength : rxLength;
+                array_size done = 0;
+                do {
+                    const array_size chunk = length - done < SpiTraceRecorder::REPLAY_CHUNK_SIZE ? length - done : SpiTraceRecorder::REPLAY_CHUNK_SIZE;
+                    const std::span<const byte> sent = done < tx.size() ? tx.subspan(done, tx.size() - done < chunk ? tx.size() - done : chunk) : std::span<const byte>();
+                    const array_size received = done < rxLength ? (rxLength - done < chunk ? rxLength - done : chunk) : 0;
+                    if (const TransferStatus status = spi->transfer(sent, std::span<byte>(scratch, received)); status != TRANSFER_OK)
+                        return toErrorCode(status);
+                    done += chunk;
+                } while (done < length);
+                ++stats.transfers;
+                stats.bytes += txLength > rxLength ? txLength : rxLength;
+            }
+        }
+        ++stats.events;
+    }
+
+    return stats;
+}
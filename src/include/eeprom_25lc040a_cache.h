@@ -0,0 +1,173 @@
+/** 
+* @file eeprom_25lc040a_cache.h
+* @brief Provides write-back cache for EEPROM_25LC040A.
+*/
+
+#ifndef EEPROM_25LC040A_CACHE_H
+	
+    /**
+    * @def EEPROM_25LC040A_CACHE_H
+    * @brief Include module macro.
+    */    
+    #define EEPROM_25LC040A_CACHE_H
+
+    #include "eeprom_25lc040a.h"
+
+    #include <chrono>
+
+    /**
+    * @class EEPROM_25LC040A_Cache
+    * @brief Write-back cache for EEPROM_25LC040A. Keeps RAM mirror of the whole device and per-page dirty bitmap.
+    * Reads are served from mirror, writes only change mirror. Dirty pages are written by EEPROM_25LC040A_Cache::flush as page bursts,
+    * so repeated writes to the same page cost single write cycle.
+    * @warning Data written after last flush is lost if device is powered off. Cache assumes it is the only writer of the device.
+    */
+    class EEPROM_25LC040A_Cache {
+    public:
+	/**
+	* @brief Count of pages of EEPROM_25LC040A.
+	*/
+        static constexpr pointer_size PAGE_COUNT = (EEPROM_25LC040A::MAX_ADDRESS + 1) / EEPROM_25LC040A::PAGE_SIZE;
+
+	/**
+	* @typedef page_mask
+	* @brief Dirty pages bitmap type. Bit @c i stands for page @c i.
+	*/
+        using page_mask = dword;
+
+	/**
+	* @param eeprom driver to cache.
+	* @throw
+	* - std::invalid_argument if eeprom == nullptr.
+	* - std::exception See EEPROM_25LC040A::readInto for information.
+	* @brief Constructs cache and loads mirror from device with single bulk read.
+	*/
+        explicit EEPROM_25LC040A_Cache(const EEPROM_25LC040A* eeprom);
+
+	/**
+	* @brief Flushes dirty pages. Errors are ignored, use EEPROM_25LC040A_Cache::flush to handle them.
+	*/
+        ~EEPROM_25LC040A_Cache();
+
+        EEPROM_25LC040A_Cache(const EEPROM_25LC040A_Cache&) = delete;
+        EEPROM_25LC040A_Cache& operator=(const EEPROM_25LC040A_Cache&) = delete;
+
+	/**
+	* @param address address to read bit from.
+	* @throw std::out_of_range @c address is greater than EEPROM_25LC040A::MAX_ADDRESS.
+	* @return read bit value.
+	* @brief Read first bit of byte from mirror. See EEPROM_25LC040A::readBit.
+	*/
+        const bit readBit(const_type<pointer_size> address) const;
+
+	/**
+	* @param address address to read byte from.
+	* @throw std::out_of_range @c address is greater than EEPROM_25LC040A::MAX_ADDRESS.
+	* @return read byte value.
+	* @brief Read byte from mirror.
+	*/
+        const byte readByte(const_type<pointer_size> address) const;
+
+	/**
+	* @param address address to read byte array from.
+	* @param buffer buffer to fill. Its size is bytes count to read.
+	* @throw std::out_of_range @c address is greater than EEPROM_25LC040A::MAX_ADDRESS.
+	* @warning Reading wraps at EEPROM_25LC040A::MAX_ADDRESS like device does.
+	* @brief Read byte array from mirror.
+	*/
+        void readInto(const_type<pointer_size> address, std::span<byte> buffer) const;
+
+	/**
+	* @param address address to write bit to.
+	* @param data bit value to write.
+	* @throw std::out_of_range @c address is greater than EEPROM_25LC040A::MAX_ADDRESS.
+	* @brief Write first bit of byte into mirror. See EEPROM_25LC040A::writeBit.
+	*/
+        void writeBit(const_type<pointer_size> address, const_type<bit> data);
+
+	/**
+	* @param address address to write byte to.
+	* @param data byte value to write.
+	* @throw std::out_of_range @c address is greater than EEPROM_25LC040A::MAX_ADDRESS.
+	* @brief Write byte into mirror and mark its page dirty.
+	*/
+        void writeByte(const_type<pointer_size> address, const_type<byte> data);
+
+	/**
+	* @param address address to write byte array to.
+	* @param data pointer to byte array to write.
+	* @param length count of bytes to write.
+	* @throw
+	* - std::invalid_argument if length == 0 or data == nullptr.
+	* - std::out_of_range @c address is greater than EEPROM_25LC040A::MAX_ADDRESS.
+	* @warning Writing wraps at EEPROM_25LC040A::MAX_ADDRESS like device does.
+	* @brief Write byte array into mirror and mark its pages dirty. Unchanged bytes don't make page dirty.
+	*/
+        void writeByteArray(const_type<pointer_size> address, const byte_array data, const_type<array_size> length);
+
+	/**
+	* @throw std::exception See EEPROM_25LC040A::writeByteArray for information. Pages which are not written stay dirty.
+	* @return count of written pages.
+	* @brief Write every dirty page into device as single page burst.
+	*/
+        pointer_size flush();
+
+	/**
+	* @param interval maximum time data may stay dirty. Zero disables periodic flush.
+	* @brief Set period for EEPROM_25LC040A_Cache::poll.
+	*/
+        void setFlushInterval(const_type<std::chrono::milliseconds> interval) noexcept;
+
+	/**
+	* @throw std::exception See EEPROM_25LC040A_Cache::flush for information.
+	* @return count of written pages.
+	* @brief Flush dirty pages if flush interval is elapsed since the first unflushed write. Should be called periodically.
+	*/
+        pointer_size poll();
+
+	/**
+	* @throw std::exception See EEPROM_25LC040A::readInto for information.
+	* @brief Discard dirty pages and reload mirror from device.
+	*/
+        void reload();
+
+	/**
+	* @return dirty pages bitmap. Bit @c i stands for page @c i.
+	* @brief Get dirty pages.
+	*/
+        page_mask dirtyPages() const noexcept;
+
+    private:
+	/**
+	* @brief Cached driver.
+	*/
+        const EEPROM_25LC040A* eeprom;
+
+	/**
+	* @brief RAM mirror of device memory.
+	*/
+        byte mirror[EEPROM_25LC040A::MAX_ADDRESS + 1]{};
+
+	/**
+	* @brief Dirty pages bitmap.
+	*/
+        page_mask dirty{0};
+
+	/**
+	* @brief Maximum time data may stay dirty.
+	*/
+        std::chrono::milliseconds flushInterval{0};
+
+	/**
+	* @brief Time of the first unflushed write.
+	*/
+        std::chrono::steady_clock::time_point dirtySince{};
+
+	/**
+	* @param address address to write byte to.
+	* @param data byte value to write.
+	* @brief Write byte into mirror and mark page dirty if byte is changed.
+	*/
+        void store(const_type<pointer_size> address, const_type<byte> data) noexcept;
+    };
+#endif
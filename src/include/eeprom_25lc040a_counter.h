@@ -0,0 +1,118 @@
+/**
+* @file eeprom_25lc040a_counter.h
+* @brief Provides wear-distributed persistent counter over region of EEPROM_25LC040A.
+*/
+
+#ifndef EEPROM_25LC040A_COUNTER_H
+
+    /**
+    * @def EEPROM_25LC040A_COUNTER_H
+    * @brief Include module macro.
+    */
+    #define EEPROM_25LC040A_COUNTER_H
+
+    #include "eeprom_25lc040a.h"
+
+    /**
+    * @class EEPROM_25LC040A_Counter
+    * @brief Persistent counter which spreads increments over ring of byte cells, so every cell is written once per ring length of increments
+    * and increment costs single byte write.
+    *
+    * Region starts with header followed by @c N cells. Value is <TT>laps * N + position</TT>: cell @c i holds low byte of count of its writes,
+    * cells before @c position are one lap ahead of the rest. Low byte of laps is read from the last cell, the rest of laps is recovered
+    * from header, which is written once per EEPROM_25LC040A_Counter::HEADER_PERIOD laps.
+    * Header is written before the cell that starts its period, so interruption between the two writes doesn't change value.
+    * @warning Counter assumes it is the only writer of the region.
+    */
+    class EEPROM_25LC040A_Counter {
+    public:
+	/**
+	* @brief Count of bytes of header: number of header period (little-endian @c dword) and check byte.
+	*/
+        static constexpr byte HEADER_SIZE = 5;
+
+	/**
+	* @brief Count of laps per header write. Laps are recovered from the last cell within window of 256 laps around header period.
+	*/
+        static constexpr dword HEADER_PERIOD = 128;
+
+	/**
+	* @param eeprom driver of device.
+	* @param address address of region start.
+	* @param length count of bytes of region: header and cells.
+	* @throw
+	* - std::invalid_argument if eeprom == nullptr or region has no room for header and two cells.
+	* - std::out_of_range region exceeds device.
+	* - std::exception See EEPROM_25LC040A_Counter::load for information.
+	* @brief Constructs counter and loads its value.
+	*/
+        EEPROM_25LC040A_Counter(const EEPROM_25LC040A* eeprom, const_type<pointer_size> address, const_type<pointer_size> length);
+
+	/**
+	* @throw std::exception See EEPROM_25LC040A::readInto and EEPROM_25LC040A_Counter::reset for information.
+	* @brief Recover value by single bulk read of region. Region without valid header is reset to 0.
+	*/
+        void load();
+
+	/**
+	* @return current value. Bus is not used.
+	*/
+        dword value() const noexcept;
+
+	/**
+	* @throw std::exception See EEPROM_25LC040A::writeAsync for information.
+	* @note Returns as soon as the byte is clocked out, its write cycle overlaps caller's work (see EEPROM_25LC040A::writeAsync).
+	* Once per EEPROM_25LC040A_Counter::HEADER_PERIOD laps header is written too.
+	* @return new value.
+	* @brief Increment value by writing single cell.
+	*/
+        dword increment();
+
+	/**
+	* @param value new value.
+	* @throw std::exception See EEPROM_25LC040A::writeByteArray for information.
+	* @brief Write header and every cell for @c value.
+	*/
+        void reset(const_type<dword> value);
+
+	/**
+	* @return count of cells. Every cell is written once per this count of increments.
+	*/
+        pointer_size cells() const noexcept;
+
+    private:
+	/**
+	* @brief Driver of device.
+	*/
+        const EEPROM_25LC040A* eeprom;
+
+	/**
+	* @brief Address of region start.
+	*/
+        pointer_size address;
+
+	/**
+	* @brief Count of cells.
+	*/
+        pointer_size count;
+
+	/**
+	* @brief Current value.
+	*/
+        dword current{0};
+
+	/**
+	* @param period period number.
+	* @param header buffer for EEPROM_25LC040A_Counter::HEADER_SIZE bytes.
+	* @brief Encode header.
+	*/
+        static void createHeader(const_type<dword> period, byte* header) noexcept;
+
+	/**
+	* @param period period number.
+	* @throw std::exception See EEPROM_25LC040A::writeByteArray for information.
+	* @brief Write header.
+	*/
+        void writeHeader(const_type<dword> period) const;
+    };
+#endif
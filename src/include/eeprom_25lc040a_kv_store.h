@@ -0,0 +1,199 @@
+/**
+* @file eeprom_25lc040a_kv_store.h
+* @brief Provides log-structured key-value store over EEPROM_25LC040A.
+*/
+
+#ifndef EEPROM_25LC040A_KV_STORE_H
+
+    /**
+    * @def EEPROM_25LC040A_KV_STORE_H
+    * @brief Include module macro.
+    */
+    #define EEPROM_25LC040A_KV_STORE_H
+
+    #include "eeprom_25lc040a.h"
+
+    /**
+    * @class EEPROM_25LC040A_KvStore
+    * @brief Append-only key-value store for small settings. Updating a key appends one record with single partial page burst,
+    * lookups are served from RAM index and never touch bus.
+    *
+    * Device is split into two segments. Active segment starts with header (magic and generation) and is followed by records:
+    * key, value length, value and CRC-8 over generation and record. Record never crosses page boundary: if it doesn't fit the rest of page
+    * it is appended to the next page. The latest record of key wins, record with empty value removes key.
+    * When active segment is full live records are compacted into the other segment, whose header is written last,
+    * so interrupted compaction leaves the old segment active.
+    * @warning Store assumes it is the only writer of the device.
+    */
+    class EEPROM_25LC040A_KvStore {
+    public:
+	/**
+	* @brief Size of segment in bytes. Live records must fit single segment.
+	*/
+        static constexpr pointer_size SEGMENT_SIZE = (EEPROM_25LC040A::MAX_ADDRESS + 1) / 2;
+
+	/**
+	* @brief Maximum key value. Key 0xFF is reserved: erased device memory is never taken for record.
+	*/
+        static constexpr byte MAX_KEY = 0xFE;
+
+	/**
+	* @brief Count of bytes of record besides value: key, length and CRC-8.
+	*/
+        static constexpr byte RECORD_OVERHEAD = 3;
+
+	/**
+	* @brief Maximum value size: record must fit single page.
+	*/
+        static constexpr byte MAX_VALUE_SIZE = EEPROM_25LC040A::PAGE_SIZE - RECORD_OVERHEAD;
+
+	/**
+	* @param eeprom driver of device.
+	* @throw
+	* - std::invalid_argument if eeprom == nullptr.
+	* - std::exception See EEPROM_25LC040A_KvStore::mount for information.
+	* @brief Constructs store and mounts it.
+	*/
+        explicit EEPROM_25LC040A_KvStore(const EEPROM_25LC040A* eeprom);
+
+	/**
+	* @throw std::exception See EEPROM_25LC040A::readInto and EEPROM_25LC040A::writeByteArray for information.
+	* @brief Read whole device by single bulk read, pick active segment and rebuild RAM index from its log. Device without valid segment is formatted.
+	*/
+        void mount();
+
+	/**
+	* @param key key to look up.
+	* @return value of key, empty if key is not stored. View stays valid until the next modification of store.
+	* @brief Get value from RAM index. Bus is not used.
+	*/
+        std::span<const byte> get(const_type<byte> key) const noexcept;
+
+	/**
+	* @param key key to look up.
+	* @return whether key is stored.
+	*/
+        bool contains(const_type<byte> key) const noexcept;
+
+	/**
+	* @param key key to store.
+	* @param value value to store. Empty value removes key.
+	* @throw
+	* - std::out_of_range @c key is greater than EEPROM_25LC040A_KvStore::MAX_KEY.
+	* - std::invalid_argument @c value is longer than EEPROM_25LC040A_KvStore::MAX_VALUE_SIZE.
+	* - std::runtime_error live records don't fit segment.
+	* - std::exception See EEPROM_25LC040A::writeByteArray for information.
+	* @note Unchanged value is not written. Otherwise single record is appended, or segment is compacted if record doesn't fit it.
+	* @brief Store value of key.
+	*/
+        void put(const_type<byte> key, std::span<const byte> value);
+
+	/**
+	* @param key key to remove.
+	* @throw See EEPROM_25LC040A_KvStore::put.
+	* @return whether key was stored.
+	* @brief Remove key by appending record with empty value.
+	*/
+        bool remove(const_type<byte> key);
+
+	/**
+	* @throw See EEPROM_25LC040A_KvStore::put.
+	* @brief Move live records into the other segment. Done automatically when active segment is full.
+	*/
+        void compact();
+
+	/**
+	* @return count of stored keys.
+	*/
+        pointer_size size() const noexcept;
+
+	/**
+	* @return count of bytes of active segment taken by header and log, including stale records and page padding.
+	*/
+        pointer_size used() const noexcept;
+
+    private:
+	/**
+	* @brief First byte of segment header.
+	*/
+        static constexpr byte MAGIC = 0x4B;
+
+	/**
+	* @brief Size of segment header: magic, generation and inverted generation.
+	*/
+        static constexpr byte HEADER_SIZE = 3;
+
+	/**
+	* @brief Driver of device.
+	*/
+        const EEPROM_25LC040A* eeprom;
+
+	/**
+	* @brief RAM mirror of active segment.
+	*/
+        byte mirror[SEGMENT_SIZE]{};
+
+	/**
+	* @brief Offset of the latest record of every key inside segment, 0 if key is not stored.
+	*/
+        pointer_size index[MAX_KEY + 1]{};
+
+	/**
+	* @brief Index of active segment: 0 or 1.
+	*/
+        byte segment{0};
+
+	/**
+	* @brief Generation of active segment. Incremented by every compaction.
+	*/
+        byte generation{0};
+
+	/**
+	* @brief Offset of the end of log inside active segment.
+	*/
+        pointer_size tail{HEADER_SIZE};
+
+	/**
+	* @param frame segment image.
+	* @param offset offset of record inside @c frame.
+	* @param generation generation of segment.
+	* @return whether valid record is placed by @c offset.
+	*/
+        static bool isRecord(const byte* frame, const_type<pointer_size> offset, const_type<byte> generation) noexcept;
+
+	/**
+	* @param frame segment image.
+	* @param offset offset of the end of log.
+	* @param generation generation of segment.
+	* @param key key to write.
+	* @param value value to write.
+	* @return offset of written record, 0 if record doesn't fit segment.
+	* @brief Write record into segment image by the end of log. Record is moved to the next page if it doesn't fit the rest of page.
+	*/
+        static pointer_size place(byte* frame, const_type<pointer_size> offset, const_type<byte> generation, const_type<byte> key, std::span<const byte> value) noexcept;
+
+	/**
+	* @param generation generation of segment.
+	* @param record key, length and value.
+	* @param length count of bytes of @c record.
+	* @return CRC-8 (polynomial 0x07) of generation and record.
+	*/
+        static byte checksum(const_type<byte> generation, const byte* record, const_type<pointer_size> length) noexcept;
+
+	/**
+	* @param key key to store.
+	* @param value value to store, empty to remove key.
+	* @throw See EEPROM_25LC040A_KvStore::put.
+	* @brief Append record or compact segment together with the record if it doesn't fit.
+	*/
+        void append(const_type<byte> key, std::span<const byte> value);
+
+	/**
+	* @param key key to change during compaction.
+	* @param value new value of @c key, empty to remove key.
+	* @throw See EEPROM_25LC040A_KvStore::put.
+	* @brief Write live records and change of @c key into the other segment, then its header.
+	*/
+        void compact(const_type<pointer_size> key, std::span<const byte> value);
+    };
+#endif
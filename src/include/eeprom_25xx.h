@@ -0,0 +1,1492 @@
+/** 
+* @file eeprom_25xx.h
+* @brief Provides 25xx SPI EEPROM driver template bound to device traits and SPI backend at compile time.
+*/
+
+#ifndef EEPROM_25XX_H
+	
+    /**
+    * @def EEPROM_25XX_H
+    * @brief Include module macro.
+    */    
+    #define EEPROM_25XX_H
+
+    #include "eeprom_25xx_stats.h"
+    #include "eeprom_25xx_traits.h"
+    #include "result.h"
+    #include "spi_interface.h"
+
+    #include <chrono>
+    #include <cstring>
+    #include <stdexcept>
+    #include <thread>
+
+    /**
+    * @typedef bit_index
+    * @brief Flat bit index for 25xx EEPROM: <TT>address * 8 + offset</TT>. Offset 0 is the most significant (first) bit of byte.
+    */
+    using bit_index = dword;
+
+    /**
+    * @class EEPROM_25xx
+    * @brief Definitions shared by every 25xx SPI EEPROM driver.
+    */
+    class EEPROM_25xx {
+    public:
+	/**
+	* @enum Command
+	* @brief Set of possible commands for 25xx EEPROM.
+	*/
+        enum Command : byte {
+            CMD_READ = 0b011, ///< Read.
+            CMD_WRITE = 0b010, ///< Write.
+            CMD_WREN = 0b110, ///< Enable writing.
+            CMD_WRDI = 0b100, ///< Disable writing.
+            CMD_RDSR = 0b101, ///< Read STATUS register. 
+            CMD_WRSR = 0b001 ///< Write STATUS register.
+        };
+
+	/**
+	* @enum StatusBit
+	* @brief Bits of STATUS register of 25xx EEPROM.
+	*/
+        enum StatusBit : byte {
+            SR_WIP = 0b0001, ///< Write-In-Process.
+            SR_WEL = 0b0010, ///< Write Enable Latch.
+            SR_BP0 = 0b0100, ///< Block Protection 0.
+            SR_BP1 = 0b1000 ///< Block Protection 1.
+        };
+
+	/**
+	* @enum BlockProtection
+	* @brief Write protected part of 25xx EEPROM set by EEPROM_25xx::SR_BP0 and EEPROM_25xx::SR_BP1 bits. Values are the bits of STATUS register.
+	*/
+        enum BlockProtection : byte {
+            PROTECT_NONE = 0, ///< Whole device is writable.
+            PROTECT_UPPER_QUARTER = SR_BP0, ///< The upper quarter of addresses is protected.
+            PROTECT_UPPER_HALF = SR_BP1, ///< The upper half of addresses is protected.
+            PROTECT_ALL = SR_BP0 | SR_BP1 ///< Whole device is protected.
+        };
+
+	/**
+	* @enum WriteMode
+	* @brief Modes of BasicEEPROM_25xx::writeByteArray.
+	*/
+        enum WriteMode : byte {
+            WRITE_ALWAYS = 0, ///< Write every page burst.
+            WRITE_SKIP_UNCHANGED = 1 ///< Read target range first and write only page bursts which differ from device content.
+        };
+
+	/**
+	* @struct ReadSegment
+	* @brief Range of BasicEEPROM_25xx::readv: bytes from @c address are read into @c buffer.
+	*/
+        struct ReadSegment {
+            pointer_size address; ///< Address of the first byte.
+            std::span<byte> buffer; ///< Buffer to fill. Its size is bytes count to read.
+        };
+
+	/**
+	* @struct WriteSegment
+	* @brief Range of BasicEEPROM_25xx::writev: @c data is written from @c address.
+	*/
+        struct WriteSegment {
+            pointer_size address; ///< Address of the first byte.
+            std::span<const byte> data; ///< Bytes to write.
+        };
+    };
+
+    /**
+    * @class BasicEEPROM_25xx
+    * @tparam Traits device description. See EEPROM_25xxTraits.
+    * @tparam Backend SPI protocol compatible driver. See ::SpiBackend.
+    * @tparam Stats statistics policy: NoDriverStats compiles statistics out, DriverStats collects them.
+    * @brief Driver class for 25xx EEPROM bound to device traits and SPI backend at compile time. Provides high level interface to interact to 25xx EEPROM.
+    * Page bursts and instruction encoding are derived from @c Traits at compile time.
+    * When @c Backend is concrete (preferably @c final) class calls to it are not virtual and whole transaction can be inlined.
+    * See ::EEPROM_25LC040A for runtime polymorphic driver.
+    *
+    * Every operation has exception-free @c noexcept counterpart with @c try prefix which returns Result. Throwing API is thin layer over it:
+    * error code is converted into exception by ::throwError, which is defined out of line, so header has no exception handling code.
+    */
+    template <typename Traits, SpiBackend Backend, typename Stats = NoDriverStats>
+    class BasicEEPROM_25xx : public EEPROM_25xx {
+    public:
+	/**
+	* @class WriteFuture
+	* @brief Handle of write started by BasicEEPROM_25xx::writeAsync. Doesn't own resources: copy it freely, it stays valid while driver lives.
+	*/
+        class WriteFuture {
+        public:
+	    /**
+	    * @throw std::exception See validateTransferStatus for information.
+	    * @return whether write cycle of the last page burst is completed. Polls STATUS register once unless completion is already known.
+	    */
+            bool ready() const;
+
+	    /**
+	    * @return See WriteFuture::ready. Error code instead of exception.
+	    */
+            Result<bool> tryReady() const noexcept;
+
+	    /**
+	    * @throw std::runtime_error write cycle is not completed in BasicEEPROM_25xx::WRITE_CYCLE_TIMEOUT.
+	    * @throw std::exception See validateTransferStatus for information.
+	    * @brief Poll STATUS register until write cycle of the last page burst is completed.
+	    */
+            void wait() const;
+
+	    /**
+	    * @return ErrorCode::ERROR_TIMEOUT or transfer error instead of exception.
+	    * @brief See WriteFuture::wait.
+	    */
+            Result<void> tryWait() const noexcept;
+
+        private:
+            friend class BasicEEPROM_25xx;
+
+	    /**
+	    * @param eeprom driver which started write.
+	    * @param sequence number of the last page burst of write.
+	    * @brief Constructs handle. Used by BasicEEPROM_25xx::writeAsync.
+	    */
+            WriteFuture(const BasicEEPROM_25xx* eeprom, const_type<dword> sequence) noexcept;
+
+	    /**
+	    * @brief Driver which started write.
+	    */
+            const BasicEEPROM_25xx* eeprom;
+
+	    /**
+	    * @brief Number of the last page burst of write. See BasicEEPROM_25xx::issued.
+	    */
+            dword sequence;
+        };
+
+	/**
+	* @brief Device size in bytes.
+	*/
+        static constexpr dword CAPACITY = Traits::CAPACITY;
+
+	/**
+	* @brief Maximum address value for device.
+	*/
+        static constexpr pointer_size MAX_ADDRESS = Traits::MAX_ADDRESS;
+
+	/**
+	* @brief Size of write page in bytes. Single CMD_WRITE instruction can't cross page boundary.
+	*/
+        static constexpr pointer_size PAGE_SIZE = Traits::PAGE_SIZE;
+
+	/**
+	* @brief Maximum flat bit index value for device. See ::bit_index.
+	*/
+        static constexpr bit_index MAX_BIT_INDEX = CAPACITY * 8 - 1;
+
+	/**
+	* @brief Maximum count of segments of BasicEEPROM_25xx::readv and BasicEEPROM_25xx::writev. Segments are sorted on stack.
+	*/
+        static constexpr byte MAX_SEGMENTS = 64;
+
+	/**
+	* @brief Default gap of BasicEEPROM_25xx::readv. Clocking gap byte costs as much as instruction byte, while every frame adds
+	* chip select overhead and backend call, so gap of few instructions is cheaper to read through than to start new frame.
+	*/
+        static constexpr array_size MERGE_GAP = Traits::INSTRUCTION_SIZE * 4;
+
+	/**
+	* @brief Maximum time to wait for internal write cycle completion. Ten times of datasheet tWC.
+	*/
+        static constexpr std::chrono::microseconds WRITE_CYCLE_TIMEOUT = Traits::WRITE_CYCLE_TIME * 10;
+
+	/**
+	* @brief Count of STATUS register polls made right away before waiting for write cycle starts to sleep.
+	*/
+        static constexpr byte QUICK_POLLS = 2;
+
+	/**
+	* @brief The shortest interval between STATUS register polls while waiting for write cycle.
+	*/
+        static constexpr std::chrono::microseconds POLL_INTERVAL_MIN{1};
+
+	/**
+	* @brief The longest interval between STATUS register polls while waiting for write cycle. Quarter of datasheet tWC.
+	*/
+        static constexpr std::chrono::microseconds POLL_INTERVAL_MAX = Traits::WRITE_CYCLE_TIME / 4;
+
+	/**
+	* @param spi SPI protocol compatible driver for device.
+	* @brief Constructs 25xx driver with SPI compatible driver.
+	*/
+       explicit BasicEEPROM_25xx(Backend* spi) noexcept;
+
+	/**
+	* @param address address to read bit from.
+	* @throw 
+	* - std::runtime_error if spi == nullptr.
+	* - std::out_of_range @c address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* - std::exception See validateTransferStatus for information.
+	* @return read bit value.
+	* @brief Read bit value by address.
+	*/
+        const bit readBit(const_type<pointer_size> address) const;
+
+	/**
+	* @param address address to read bit from.
+	* @return read bit value or error code. See BasicEEPROM_25xx::readBit.
+	*/
+        Result<bit> tryReadBit(const_type<pointer_size> address) const noexcept;
+
+	/**
+	* @brief Read byte value by address.
+        * @param address address to read byte from.
+        * @throw 
+	* - std::runtime_error if spi == nullptr.
+	* - std::out_of_range @c address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* - std::exception See validateTransferStatus for information.
+        * @return read byte value.
+        */	
+        const byte readByte(const_type<pointer_size> address) const;
+
+	/**
+	* @param address address to read byte from.
+	* @return read byte value or error code. See BasicEEPROM_25xx::readByte.
+	*/
+        Result<byte> tryReadByte(const_type<pointer_size> address) const noexcept;
+
+	/**
+	* @brief Read byte array by address.
+        * @param address address to read byte array from.
+	* @param length bytes count to read.
+        * @throw 
+	* - std::runtime_error if spi == nullptr.
+	* - std::invalid_argument if length == 0.
+	* - std::out_of_range @c address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* - std::exception See validateTransferStatus for information.
+        * @return pointer to requested segment.
+	* @note received byte array must be released <TT><b>manually</b></TT>. Use BasicEEPROM_25xx::readInto to avoid allocation.
+	* @warning if <TT>address + length > BasicEEPROM_25xx::MAX_ADDRESS</TT>. When internal "pointer" of reading data from @c memory will reach <TT>BasicEEPROM_25xx::MAX_ADDRESS + 1</TT> "pointer" will be assigned @c NULL and will continue reading unless all requested data is read.
+        */
+        const byte_array readByteArray(const_type<pointer_size> address, const_type<array_size> length) const;
+
+	/**
+	* @brief Read byte array of any length by address into caller provided buffer by single CMD_READ frame. No memory is allocated.
+        * @param address address to read byte array from.
+	* @param buffer buffer to fill. Its size is bytes count to read.
+        * @throw 
+	* - std::runtime_error if spi == nullptr.
+	* - std::invalid_argument if buffer is empty.
+	* - std::out_of_range @c address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* - std::exception See validateTransferStatus for information.
+	* @warning if <TT>address + buffer.size() > BasicEEPROM_25xx::MAX_ADDRESS</TT>. Reading continues from @c NULL address unless @c buffer is filled.
+	* @note Data is streamed: CS is held low while data is clocked into @c buffer, so whole device is read by single frame without copying.
+        */
+        void readInto(const_type<pointer_size> address, std::span<byte> buffer) const;
+
+	/**
+	* @param address address to read byte array from.
+	* @param buffer buffer to fill.
+	* @return error code. See BasicEEPROM_25xx::readInto.
+	*/
+        Result<void> tryReadInto(const_type<pointer_size> address, std::span<byte> buffer) const noexcept;
+
+	/**
+	* @brief Read byte by address into caller provided variable. No memory is allocated.
+        * @param address address to read byte from.
+	* @param value variable to fill.
+        * @throw See BasicEEPROM_25xx::readInto.
+        */
+        void readInto(const_type<pointer_size> address, byte& value) const;
+
+	/**
+	* @brief Read bit range starting from flat bit index.
+        * @param first flat bit index of the first bit to read. See ::bit_index.
+	* @param values buffer to fill. Its size is bits count to read.
+        * @throw 
+	* - std::invalid_argument if values is empty or range covers some byte twice (longer than whole device).
+	* - std::out_of_range @c first is greater than BasicEEPROM_25xx::MAX_BIT_INDEX.
+	* - See BasicEEPROM_25xx::readInto for other exceptions.
+	* @note Affected bytes are read by as few transactions as possible. Range wraps at BasicEEPROM_25xx::MAX_BIT_INDEX.
+        */
+        void readBits(const_type<bit_index> first, std::span<bit> values) const;
+
+	/**
+	* @param first flat bit index of the first bit to read.
+	* @param values buffer to fill.
+	* @return error code. See BasicEEPROM_25xx::readBits(const_type<bit_index>, std::span<bit>).
+	*/
+        Result<void> tryReadBits(const_type<bit_index> first, std::span<bit> values) const noexcept;
+
+	/**
+	* @brief Read bit range starting from bit @c offset of byte by @c address.
+        * @param address address of byte with the first bit to read.
+	* @param offset bit offset inside byte. 0 is the most significant bit.
+	* @param values buffer to fill. Its size is bits count to read.
+        * @throw std::out_of_range if offset is greater than 7. See BasicEEPROM_25xx::readBits(const_type<bit_index>, std::span<bit>) for other exceptions.
+        */
+        void readBits(const_type<pointer_size> address, const_type<byte> offset, std::span<bit> values) const;
+
+	/**
+	* @param address address to write bit to.
+	* @param data bit value to write.
+	* @throw std::exception See validateTransferStatus for information.
+	* - std::out_of_range @c address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* @note Rewrite first bit by given address. Preserves other 7 bits in current byte.
+	* @brief Write bit value by address.
+	*/
+        void writeBit(const_type<pointer_size> address, const_type<bit> data) const;
+
+	/**
+	* @param address address to write bit to.
+	* @param data bit value to write.
+	* @return error code. See BasicEEPROM_25xx::writeBit.
+	*/
+        Result<void> tryWriteBit(const_type<pointer_size> address, const_type<bit> data) const noexcept;
+
+	/**
+	* @param address address to write byte to.
+	* @param data byte value to write.
+	* @throw std::exception See validateTransferStatus for information.
+	* - std::out_of_range @c address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* @brief Write byte value by address.
+	*/ 
+        void writeByte(const_type<pointer_size> address, const_type<byte> data) const;
+
+	/**
+	* @param address address to write byte to.
+	* @param data byte value to write.
+	* @return error code. See BasicEEPROM_25xx::writeByte.
+	*/
+        Result<void> tryWriteByte(const_type<pointer_size> address, const_type<byte> data) const noexcept;
+
+	/**
+	* @param address address to write byte array to.
+	* @param data pointer to byte array to write.
+	* @param length count of bytes to write.
+	* @param mode write mode. See EEPROM_25xx::WriteMode.
+	* @throw std::exception See validateTransferStatus for information.
+	* - std::out_of_range @c address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* - std::runtime_error write cycle is not completed in BasicEEPROM_25xx::WRITE_CYCLE_TIMEOUT.
+	* @warning if <TT>address + length > BasicEEPROM_25xx::MAX_ADDRESS</TT>. When internal "pointer" of writing data from @c memory will reach <TT>BasicEEPROM_25xx::MAX_ADDRESS + 1</TT> "pointer" will be assigned @c NULL and will continue writing unless all requested data is written.
+	* @note Data is split into page aligned bursts (see BasicEEPROM_25xx::PAGE_SIZE). Every burst is preceded by CMD_WREN and followed by STATUS register polling until write cycle is completed.
+	* See BasicEEPROM_25xx::writeAsync to overlap the last write cycle with caller's work.
+	* In EEPROM_25xx::WRITE_SKIP_UNCHANGED mode target range is read first and bursts equal to device content are not written.
+	* @return count of skipped page bursts. Always 0 in EEPROM_25xx::WRITE_ALWAYS mode.
+	* @brief Write byte array by address.
+	*/
+        pointer_size writeByteArray(const_type<pointer_size> address, const byte_array data, const_type<array_size> length, const_type<WriteMode> mode = WRITE_ALWAYS) const;
+
+	/**
+	* @param address address to write byte array to.
+	* @param data bytes to write.
+	* @param mode write mode. See EEPROM_25xx::WriteMode.
+	* @return count of skipped page bursts or error code. See BasicEEPROM_25xx::writeByteArray.
+	*/
+        Result<pointer_size> tryWriteByteArray(const_type<pointer_size> address, std::span<const byte> data, const_type<WriteMode> mode = WRITE_ALWAYS) const noexcept;
+
+	/**
+	* @param address address to write byte array to.
+	* @param data bytes to write.
+	* @throw
+	* - std::invalid_argument if data is empty.
+	* - See BasicEEPROM_25xx::writeByteArray for other exceptions.
+	* @note Returns as soon as the last page burst is clocked out, so caller's work overlaps its write cycle.
+	* Write cycle is awaited lazily: only the next operation which needs device (read, write or BasicEEPROM_25xx::WriteFuture::wait) polls STATUS register.
+	* Bursts before the last one still wait for each other, because device accepts nothing else while write cycle is in progress.
+	* @return handle of write to check or wait for completion.
+	* @brief Write byte array by address without waiting for the last write cycle.
+	*/
+        WriteFuture writeAsync(const_type<pointer_size> address, std::span<const byte> data) const;
+
+	/**
+	* @param address address to write byte array to.
+	* @param data bytes to write.
+	* @return handle of write or error code. See BasicEEPROM_25xx::writeAsync.
+	*/
+        Result<WriteFuture> tryWriteAsync(const_type<pointer_size> address, std::span<const byte> data) const noexcept;
+
+	/**
+	* @brief Write bit range starting from flat bit index. Other bits of affected bytes are preserved.
+        * @param first flat bit index of the first bit to write. See ::bit_index.
+	* @param values bits to write.
+        * @throw 
+	* - std::invalid_argument if values is empty or range covers some byte twice (longer than whole device).
+	* - std::out_of_range @c first is greater than BasicEEPROM_25xx::MAX_BIT_INDEX.
+	* - See BasicEEPROM_25xx::writeByteArray for other exceptions.
+	* @note Affected bytes are read by as few transactions as possible, changed and written back with one page burst per changed page. Range wraps at BasicEEPROM_25xx::MAX_BIT_INDEX.
+        */
+        void writeBits(const_type<bit_index> first, std::span<const bit> values) const;
+
+	/**
+	* @param first flat bit index of the first bit to write.
+	* @param values bits to write.
+	* @return error code. See BasicEEPROM_25xx::writeBits(const_type<bit_index>, std::span<const bit>).
+	*/
+        Result<void> tryWriteBits(const_type<bit_index> first, std::span<const bit> values) const noexcept;
+
+	/**
+	* @brief Write bit range starting from bit @c offset of byte by @c address.
+        * @param address address of byte with the first bit to write.
+	* @param offset bit offset inside byte. 0 is the most significant bit.
+	* @param values bits to write.
+        * @throw std::out_of_range if offset is greater than 7. See BasicEEPROM_25xx::writeBits(const_type<bit_index>, std::span<const bit>) for other exceptions.
+        */
+        void writeBits(const_type<pointer_size> address, const_type<byte> offset, std::span<const bit> values) const;
+
+	/**
+	* @brief Read scattered ranges by as few CMD_READ frames as possible.
+	* @param segments ranges to read. See EEPROM_25xx::ReadSegment.
+	* @param gap the longest distance between sorted ranges which are read by single frame. Bytes of gap are clocked and dropped.
+	* @throw
+	* - std::runtime_error if spi == nullptr.
+	* - std::invalid_argument if segments is empty or longer than BasicEEPROM_25xx::MAX_SEGMENTS, or some buffer is empty.
+	* - std::out_of_range some range exceeds BasicEEPROM_25xx::MAX_ADDRESS. Ranges don't wrap.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* - std::exception See validateTransferStatus for information.
+	* @note Ranges are sorted by address and merged into runs: range which starts no further than @c gap past the end of run joins it.
+	* Every run is single frame: data is clocked straight into buffers, overlapped bytes are copied from buffer which received them.
+	* @return count of CMD_READ frames.
+	*/
+        dword readv(std::span<const ReadSegment> segments, const_type<array_size> gap = MERGE_GAP) const;
+
+	/**
+	* @param segments ranges to read.
+	* @param gap the longest distance between ranges read by single frame.
+	* @return count of frames or error code. See BasicEEPROM_25xx::readv.
+	*/
+        Result<dword> tryReadv(std::span<const ReadSegment> segments, const_type<array_size> gap = MERGE_GAP) const noexcept;
+
+	/**
+	* @brief Write scattered ranges by as few page bursts as possible.
+	* @param segments ranges to write. See EEPROM_25xx::WriteSegment.
+	* @param gap the longest distance between ranges of the same page which are written by single page burst. Bytes of gap are read from device
+	* and written back unchanged. Default is whole page: extra read frame is far cheaper than extra write cycle.
+	* @throw
+	* - std::invalid_argument if ranges overlap, or see BasicEEPROM_25xx::readv.
+	* - See BasicEEPROM_25xx::readv and BasicEEPROM_25xx::writeByteArray for other exceptions.
+	* @note Ranges are sorted by address and cut at page boundaries, so range of several pages is split and neighbouring ranges share bursts.
+	* @return count of page bursts.
+	*/
+        dword writev(std::span<const WriteSegment> segments, const_type<array_size> gap = PAGE_SIZE) const;
+
+	/**
+	* @param segments ranges to write.
+	* @param gap the longest distance between ranges written by single page burst.
+	* @return count of page bursts or error code. See BasicEEPROM_25xx::writev.
+	*/
+        Result<dword> tryWritev(std::span<const WriteSegment> segments, const_type<array_size> gap = PAGE_SIZE) const noexcept;
+
+	/**
+	* @throw
+	* - std::runtime_error if spi == nullptr.
+	* - std::exception See validateTransferStatus for information.
+	* @return STATUS register value. See EEPROM_25xx::StatusBit.
+	* @brief Read STATUS register by single CMD_RDSR frame.
+	*/
+        byte readStatus() const;
+
+	/**
+	* @return STATUS register value or error code. See BasicEEPROM_25xx::readStatus.
+	*/
+        Result<byte> tryReadStatus() const noexcept;
+
+	/**
+	* @param value new STATUS register value. Only EEPROM_25xx::SR_BP0 and EEPROM_25xx::SR_BP1 are writable, other bits are ignored.
+	* @throw
+	* - std::runtime_error if spi == nullptr.
+	* - std::runtime_error device is stopped. Should use BasicEEPROM_25xx::resume.
+	* - std::runtime_error write cycle is not completed in BasicEEPROM_25xx::WRITE_CYCLE_TIMEOUT.
+	* - std::exception See validateTransferStatus for information.
+	* @note Block protection bits are non-volatile: CMD_WRSR starts write cycle like page burst does and it is awaited.
+	* @brief Enable writing and write STATUS register.
+	*/
+        void writeStatus(const_type<byte> value) const;
+
+	/**
+	* @param value new STATUS register value.
+	* @return error code. See BasicEEPROM_25xx::writeStatus.
+	*/
+        Result<void> tryWriteStatus(const_type<byte> value) const noexcept;
+
+	/**
+	* @throw See BasicEEPROM_25xx::readStatus.
+	* @return write protected part of device.
+	*/
+        BlockProtection getBlockProtection() const;
+
+	/**
+	* @param protection write protected part of device.
+	* @throw See BasicEEPROM_25xx::writeStatus.
+	* @note Device ignores writes to protected part: page bursts into it are clocked out, but memory is not changed.
+	* @brief Set write protected part of device.
+	*/
+        void setBlockProtection(const_type<BlockProtection> protection) const;
+
+	/**
+	* @param protection write protected part of device.
+	* @return the lowest protected address, BasicEEPROM_25xx::CAPACITY if nothing is protected.
+	*/
+        static constexpr dword protectedFrom(const_type<BlockProtection> protection) noexcept;
+
+	/**
+	* @brief Stop device.
+	*/
+        inline void stop() noexcept;
+
+	/**
+	* @brief Resume device.
+	*/
+        inline void resume() noexcept;
+
+	/**
+	* @return statistics of driver, see @c Stats. DriverStats::snapshot may be called by any thread.
+	*/
+        const Stats& getStats() const noexcept;
+
+	/**
+	* @brief Reset statistics of driver. Must be called by thread which uses driver.
+	*/
+        void resetStats() const noexcept;
+    private:
+	/**
+	* @brief Size of stack buffers used by reads and read-modify-write operations. Multiple of page size.
+	*/
+        static constexpr array_size BUFFER_SIZE = CAPACITY < 512 ? CAPACITY : 512;
+
+	/**
+	* @brief SPI protocol compatible driver.
+	*/
+        Backend* spi;
+
+	/**
+	* @brief Device is working now.
+	*/
+        bool isWorking = true;
+
+	/**
+	* @brief Count of page bursts started by driver. The last one may still be in its write cycle.
+	*/
+        mutable dword issued = 0;
+
+	/**
+	* @brief Count of page bursts which write cycle is known to be completed.
+	*/
+        mutable dword completed = 0;
+
+	/**
+	* @brief Time point when the last page burst (or CMD_WRSR) was clocked out: its write cycle started.
+	*/
+        mutable std::chrono::steady_clock::time_point issuedAt{};
+
+	/**
+	* @brief Expected write cycle time learned from completed write cycles. Starts from datasheet tWC.
+	*/
+        mutable std::chrono::nanoseconds writeCycleEstimate{Traits::WRITE_CYCLE_TIME};
+
+	/**
+	* @brief Statistics of driver. Takes no space with NoDriverStats.
+	*/
+        [[no_unique_address]] mutable Stats stats;
+
+	/**
+	* @param address address to validate.
+	* @return
+	* - ErrorCode::ERROR_NO_BACKEND if spi == nullptr.
+	* - ErrorCode::ERROR_OUT_OF_RANGE address is greater than BasicEEPROM_25xx::MAX_ADDRESS.
+	* - ErrorCode::ERROR_STOPPED device is not working (BasicEEPROM_25xx::isWorking == false).
+	* @brief Validate backend, address and whether device is working.
+	*/
+        inline Result<void> validate(const_type<pointer_size> address) const noexcept;
+
+	/**
+	* @return ErrorCode::ERROR_TIMEOUT write cycle is not completed in BasicEEPROM_25xx::WRITE_CYCLE_TIMEOUT, or transfer error.
+	* @brief Poll STATUS register until EEPROM_25xx::SR_WIP bit is cleared. Polling adapts to device:
+	* BasicEEPROM_25xx::QUICK_POLLS polls right away catch short or already overlapped cycles, then driver sleeps till half of expected cycle time
+	* and polls with doubling interval. Expected time is learned from every awaited cycle, so polls neither start too early nor sleep too long.
+	*/
+        Result<void> waitWriteComplete() const noexcept;
+
+	/**
+	* @return See BasicEEPROM_25xx::waitWriteComplete.
+	* @brief Wait for write cycle of the last page burst if its completion is not known yet. Must precede every instruction except CMD_RDSR.
+	*/
+        Result<void> settle() const noexcept;
+
+	/**
+	* @param address address to write page burst to.
+	* @param data pointer to bytes to write.
+	* @param length count of bytes to write. Must not cross page boundary.
+	* @return transfer error or ErrorCode::ERROR_TIMEOUT write cycle of previous burst is not completed in BasicEEPROM_25xx::WRITE_CYCLE_TIMEOUT.
+	* @brief Wait for previous write cycle, enable writing and write single page burst. Its write cycle is not awaited, see BasicEEPROM_25xx::settle.
+	*/
+        Result<void> writePage(const_type<pointer_size> address, const byte* data, const_type<pointer_size> length) const noexcept;
+
+	/**
+	* @param address address to write byte array to.
+	* @param data pointer to bytes to write.
+	* @param length count of bytes to write.
+	* @param current current device content of the range or @c nullptr to write every burst.
+	* @return count of skipped page bursts or error code. See BasicEEPROM_25xx::writePage.
+	* @brief Split range into page bursts and write those which differ from @c current.
+	*/
+        Result<pointer_size> writeBursts(const_type<pointer_size> address, const byte* data, const_type<array_size> length, const byte* current) const noexcept;
+
+	/**
+	* @param segments ranges of BasicEEPROM_25xx::readv.
+	* @param order indices of run ranges sorted by address.
+	* @param count count of run ranges.
+	* @return transfer error code.
+	* @brief Read run of sorted ranges by single CMD_READ frame.
+	*/
+        Result<void> readRun(std::span<const ReadSegment> segments, const byte* order, const_type<byte> count) const noexcept;
+
+	/**
+	* @tparam Segment EEPROM_25xx::ReadSegment or EEPROM_25xx::WriteSegment.
+	* @param segments ranges to validate.
+	* @param order buffer for indices of ranges sorted by address.
+	* @return See BasicEEPROM_25xx::readv for error codes.
+	* @brief Validate ranges of BasicEEPROM_25xx::readv or BasicEEPROM_25xx::writev and sort them. Insertion sort is stable and has no allocation.
+	*/
+        template <typename Segment>
+        Result<void> sortSegments(std::span<const Segment> segments, byte* order) const noexcept;
+
+	/**
+	* @param tx bytes to send.
+	* @param rx buffer for received bytes.
+	* @return transfer error code.
+	* @brief Execute single full-duplex transaction: set CS low, transfer, set CS high. Uses <TT>Backend::transact</TT> when backend provides it.
+	*/
+        Result<void> transact(std::span<const byte> tx, std::span<byte> rx) const noexcept;
+
+	/**
+	* @param operation measured operation.
+	* @param bytes count of device bytes read or written by operation.
+	* @param body operation itself: @c noexcept callable which returns Result.
+	* @return result of @c body.
+	* @brief Execute operation between <TT>Stats::enter</TT> and <TT>Stats::leave</TT>. Is just call of @c body with NoDriverStats.
+	*/
+        template <typename Body>
+        auto measure(const_type<DriverOperation> operation, const_type<array_size> bytes, Body body) const noexcept;
+
+	/**
+	* @param address address of window start.
+	* @param remaining count of bytes left in range.
+	* @return count of bytes of the next window. Window fits BasicEEPROM_25xx::BUFFER_SIZE and, unless it is the last one, ends on page boundary.
+	* @brief Split long range into page aligned windows for stack buffers.
+	*/
+        static array_size windowSize(const_type<pointer_size> address, const_type<array_size> remaining) noexcept;
+    };
+
+    /**
+    * @typedef BasicEEPROM_25LC040A
+    * @tparam Backend SPI protocol compatible driver. See ::SpiBackend.
+    * @tparam Stats statistics policy. See BasicEEPROM_25xx.
+    * @brief Driver for 25LC040A bound to SPI backend at compile time.
+    */
+    template <SpiBackend Backend, typename Stats = NoDriverStats>
+    using BasicEEPROM_25LC040A = BasicEEPROM_25xx<EEPROM_25LC040A_Traits, Backend, Stats>;
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    BasicEEPROM_25xx<Traits, Backend, Stats>::BasicEEPROM_25xx(Backend* spi) noexcept : spi(spi) {}
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    const bit BasicEEPROM_25xx<Traits, Backend, Stats>::readBit(const_type<pointer_size> address) const {
+        const Result<bit> result = tryReadBit(address);
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::readBit()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<bit> BasicEEPROM_25xx<Traits, Backend, Stats>::tryReadBit(const_type<pointer_size> address) const noexcept {
+        return measure(OP_READ_BIT, 1, [&]() noexcept -> Result<bit> {
+            const Result<byte> value = tryReadByte(address);
+            if (!value)
+                return value.error();
+
+            return static_cast<bit>(value.value() >> 7);
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    const byte BasicEEPROM_25xx<Traits, Backend, Stats>::readByte(const_type<pointer_size> address) const {
+        const Result<byte> result = tryReadByte(address);
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::readByte()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<byte> BasicEEPROM_25xx<Traits, Backend, Stats>::tryReadByte(const_type<pointer_size> address) const noexcept {
+        return measure(OP_READ_BYTE, 1, [&]() noexcept -> Result<byte> {
+            byte value;
+            if (const Result<void> result = tryReadInto(address, std::span<byte>(&value, 1)); !result)
+                return result.error();
+
+            return value;
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    const byte_array BasicEEPROM_25xx<Traits, Backend, Stats>::readByteArray(const_type<pointer_size> address, const_type<array_size> length) const {
+        if (!spi)
+            throwError(ERROR_NO_BACKEND, "EEPROM_25xx::readByteArray()");
+        if (!length)
+            throwError(ERROR_INVALID_ARGUMENT, "EEPROM_25xx::readByteArray()");
+        if (const Result<void> result = validate(address); !result)
+            throwError(result.error(), "EEPROM_25xx::readByteArray()");
+
+        const byte_array data = new byte[length];
+        if (const Result<void> result = tryReadInto(address, std::span<byte>(data, length)); !result) {
+            delete[] data;
+            throwError(result.error(), "EEPROM_25xx::readByteArray()");
+        }
+
+        return data;
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::readInto(const_type<pointer_size> address, std::span<byte> buffer) const {
+        if (const Result<void> result = tryReadInto(address, buffer); !result)
+            throwError(result.error(), "EEPROM_25xx::readInto()");
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::tryReadInto(const_type<pointer_size> address, std::span<byte> buffer) const noexcept {
+        return measure(OP_READ_INTO, buffer.size(), [&]() noexcept -> Result<void> {
+            if (!spi)
+                return ERROR_NO_BACKEND;
+            if (buffer.empty())
+                return ERROR_INVALID_ARGUMENT;
+            if (const Result<void> result = validate(address); !result)
+                return result;
+            if (const Result<void> result = settle(); !result)
+                return result;
+
+            // Read order:
+            // 1. Set CS low.
+            // 2. Push CMD_READ instruction.
+            // 3. Clock data straight into buffer: device streams data and wraps address at the end of memory unless CS is set high.
+            // 4. Set CS high.
+            byte instruction[Traits::INSTRUCTION_SIZE];
+            Traits::encodeInstruction(instruction, CMD_READ, address);
+
+            spi->chipDeselect();
+            TransferStatus status = spi->transfer(instruction, {});
+            if (status == TRANSFER_OK)
+                status = spi->transfer({}, buffer);
+            spi->chipSelect();
+            stats.instruction(CMD_READ);
+
+            return toErrorCode(status);
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::readInto(const_type<pointer_size> address, byte& value) const {
+        readInto(address, std::span<byte>(&value, 1));
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::readBits(const_type<bit_index> first, std::span<bit> values) const {
+        if (const Result<void> result = tryReadBits(first, values); !result)
+            throwError(result.error(), "EEPROM_25xx::readBits()");
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::tryReadBits(const_type<bit_index> first, std::span<bit> values) const noexcept {
+        return measure(OP_READ_BITS, (first % 8 + values.size() + 7) / 8, [&]() noexcept -> Result<void> {
+            if (values.empty() || first % 8 + values.size() > CAPACITY * 8)
+                return ERROR_INVALID_ARGUMENT;
+            if (first > MAX_BIT_INDEX)
+                return ERROR_OUT_OF_RANGE;
+
+            // Affected bytes are read window by window
+            const pointer_size address = first / 8;
+            const byte offset = first % 8;
+            const array_size count = (offset + values.size() + 7) / 8;
+            byte buffer[BUFFER_SIZE];
+            array_size done = 0;
+            while (done < count) {
+                const pointer_size position = (address + done) % CAPACITY;
+                const array_size window = windowSize(position, count - done);
+                if (const Result<void> result = tryReadInto(position, std::span<byte>(buffer, window)); !result)
+                    return result;
+
+                // Extract bits of the window: bit i is placed at (offset + i) bit of range
+                const array_size from = done * 8 > offset ? done * 8 - offset : 0;
+                const array_size to = (done + window) * 8 - offset < values.size() ? (done + window) * 8 - offset : values.size();
+                for (array_size i = from; i < to; ++i) {
+                    const array_size bitPosition = offset + i - done * 8;
+                    values[i] = buffer[bitPosition / 8] >> (7 - bitPosition % 8) & 1;
+                }
+
+                done += window;
+            }
+            return {};
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::readBits(const_type<pointer_size> address, const_type<byte> offset, std::span<bit> values) const {
+        if (offset > 7 || address > MAX_ADDRESS)
+            throwError(ERROR_OUT_OF_RANGE, "EEPROM_25xx::readBits()");
+
+        readBits(bit_index{address} * 8 + offset, values);
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::writeBits(const_type<bit_index> first, std::span<const bit> values) const {
+        if (const Result<void> result = tryWriteBits(first, values); !result)
+            throwError(result.error(), "EEPROM_25xx::writeBits()");
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::tryWriteBits(const_type<bit_index> first, std::span<const bit> values) const noexcept {
+        return measure(OP_WRITE_BITS, (first % 8 + values.size() + 7) / 8, [&]() noexcept -> Result<void> {
+            if (values.empty() || first % 8 + values.size() > CAPACITY * 8)
+                return ERROR_INVALID_ARGUMENT;
+            if (first > MAX_BIT_INDEX)
+                return ERROR_OUT_OF_RANGE;
+
+            // Write order (window by window, see BasicEEPROM_25xx::windowSize):
+            // 1. Read all affected bytes of window at once.
+            // 2. Merge new bits, other bits are preserved.
+            // 3. Write changed pages back, one page burst per page (see BasicEEPROM_25xx::writeBursts).
+            const pointer_size address = first / 8;
+            const byte offset = first % 8;
+            const array_size count = (offset + values.size() + 7) / 8;
+            byte save[BUFFER_SIZE];
+            byte buffer[BUFFER_SIZE];
+            array_size done = 0;
+            while (done < count) {
+                const pointer_size position = (address + done) % CAPACITY;
+                const array_size window = windowSize(position, count - done);
+
+                // 1. Save affected bytes
+                if (const Result<void> result = tryReadInto(position, std::span<byte>(save, window)); !result)
+                    return result;
+                std::memcpy(buffer, save, window);
+
+                // 2. Merge bits
+                const array_size from = done * 8 > offset ? done * 8 - offset : 0;
+                const array_size to = (done + window) * 8 - offset < values.size() ? (done + window) * 8 - offset : values.size();
+                for (array_size i = from; i < to; ++i) {
+                    const array_size bitPosition = offset + i - done * 8;
+                    byte& slot = buffer[bitPosition / 8];
+                    const byte mask = 0x80 >> bitPosition % 8;
+                    slot = values[i] ? slot | mask : slot & ~mask;
+                }
+
+                // 3. Write back changed pages
+                if (const Result<pointer_size> result = writeBursts(position, buffer, window, save); !result)
+                    return result.error();
+
+                done += window;
+            }
+            return settle();
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::writeBits(const_type<pointer_size> address, const_type<byte> offset, std::span<const bit> values) const {
+        if (offset > 7 || address > MAX_ADDRESS)
+            throwError(ERROR_OUT_OF_RANGE, "EEPROM_25xx::writeBits()");
+
+        writeBits(bit_index{address} * 8 + offset, values);
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    dword BasicEEPROM_25xx<Traits, Backend, Stats>::readv(std::span<const ReadSegment> segments, const_type<array_size> gap) const {
+        const Result<dword> result = tryReadv(segments, gap);
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::readv()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<dword> BasicEEPROM_25xx<Traits, Backend, Stats>::tryReadv(std::span<const ReadSegment> segments, const_type<array_size> gap) const noexcept {
+        array_size bytes = 0;
+        for (const ReadSegment& segment : segments)
+            bytes += segment.buffer.size();
+
+        return measure(OP_READV, bytes, [&]() noexcept -> Result<dword> {
+            byte order[MAX_SEGMENTS];
+            if (const Result<void> result = sortSegments(segments, order); !result)
+                return result.error();
+            if (const Result<void> result = settle(); !result)
+                return result.error();
+
+            // Sorted ranges are split into runs: range which starts no further than gap past the end of run joins it
+            dword frames = 0;
+            byte first = 0;
+            while (first < segments.size()) {
+                dword end = segments[order[first]].address + segments[order[first]].buffer.size();
+                byte last = first + 1;
+                for (; last < segments.size() && segments[order[last]].address <= end + gap; ++last) {
+                    const ReadSegment& segment = segments[order[last]];
+                    if (segment.address + segment.buffer.size() > end)
+                        end = segment.address + segment.buffer.size();
+                }
+
+                if (const Result<void> result = readRun(segments, order + first, last - first); !result)
+                    return result.error();
+                ++frames;
+                first = last;
+            }
+            return frames;
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    dword BasicEEPROM_25xx<Traits, Backend, Stats>::writev(std::span<const WriteSegment> segments, const_type<array_size> gap) const {
+        const Result<dword> result = tryWritev(segments, gap);
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::writev()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<dword> BasicEEPROM_25xx<Traits, Backend, Stats>::tryWritev(std::span<const WriteSegment> segments, const_type<array_size> gap) const noexcept {
+        array_size bytes = 0;
+        for (const WriteSegment& segment : segments)
+            bytes += segment.data.size();
+
+        return measure(OP_WRITEV, bytes, [&]() noexcept -> Result<dword> {
+            byte order[MAX_SEGMENTS];
+            if (const Result<void> result = sortSegments(segments, order); !result)
+                return result.error();
+            for (byte i = 1; i < segments.size(); ++i) {
+                const WriteSegment& previous = segments[order[i - 1]];
+                if (segments[order[i]].address < previous.address + previous.data.size())
+                    return ERROR_INVALID_ARGUMENT;
+            }
+
+            // Ranges are cut at page boundaries. Pieces of the same page no further than gap apart are collected in page image
+            // (indexed by address inside page) and written by single burst, gap bytes are read from device into image first.
+            byte page[PAGE_SIZE];
+            pointer_size start = 0;
+            pointer_size end = 0;
+            dword bursts = 0;
+            for (byte i = 0; i < segments.size(); ++i) {
+                const WriteSegment& segment = segments[order[i]];
+                array_size done = 0;
+                while (done < segment.data.size()) {
+                    const pointer_size position = segment.address + done;
+                    const pointer_size room = PAGE_SIZE - position % PAGE_SIZE;
+                    const pointer_size chunk = segment.data.size() - done < room ? segment.data.size() - done : room;
+
+                    if (start != end && position / PAGE_SIZE == start / PAGE_SIZE && array_size(position - end) <= gap) {
+                        if (position > end)
+                            if (const Result<void> result = tryReadInto(end, std::span<byte>(page + end % PAGE_SIZE, position - end)); !result)
+                                return result.error();
+                    } else {
+                        if (start != end) {
+                            if (const Result<void> result = writePage(start, page + start % PAGE_SIZE, end - start); !result)
+                                return result.error();
+                            ++bursts;
+                        }
+                        start = position;
+                    }
+                    std::memcpy(page + position % PAGE_SIZE, segment.data.data() + done, chunk);
+                    end = position + chunk;
+
+                    done += chunk;
+                }
+            }
+            if (const Result<void> result = writePage(start, page + start % PAGE_SIZE, end - start); !result)
+                return result.error();
+            if (const Result<void> result = settle(); !result)
+                return result.error();
+            return bursts + 1;
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::writeBit(const_type<pointer_size> address, const_type<bit> data) const {
+        if (const Result<void> result = tryWriteBit(address, data); !result)
+            throwError(result.error(), "EEPROM_25xx::writeBit()");
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::tryWriteBit(const_type<pointer_size> address, const_type<bit> data) const noexcept {
+        return measure(OP_WRITE_BIT, 1, [&]() noexcept -> Result<void> {
+            if (const Result<void> result = validate(address); !result)
+                return result;
+
+            // Note: BIT must be written then other 7 bites of bytes cannot be changed. Furthermore, firstly 1 bytes must be read and saved.
+            // After this happens bit must be put and written into memory. For example:
+            // 1000_0000 - byte in memory. We need to put '0' then
+            // 0000_0000 - will be after record.
+            return tryWriteBits(bit_index{address} * 8, std::span<const bit>(&data, 1));
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::writeByte(const_type<pointer_size> address, const_type<byte> data) const {
+        if (const Result<void> result = tryWriteByte(address, data); !result)
+            throwError(result.error(), "EEPROM_25xx::writeByte()");
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::tryWriteByte(const_type<pointer_size> address, const_type<byte> data) const noexcept {
+        return measure(OP_WRITE_BYTE, 1, [&]() noexcept -> Result<void> {
+            if (const Result<void> result = validate(address); !result)
+                return result;
+            if (const Result<void> result = writePage(address, &data, 1); !result)
+                return result;
+
+            return settle();
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    pointer_size BasicEEPROM_25xx<Traits, Backend, Stats>::writeByteArray(const_type<pointer_size> address, const byte_array data, const_type<array_size> length, const_type<WriteMode> mode) const {
+        if (!data)
+            throwError(ERROR_INVALID_ARGUMENT, "EEPROM_25xx::writeByteArray()");
+
+        const Result<pointer_size> result = tryWriteByteArray(address, std::span<const byte>(data, length), mode);
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::writeByteArray()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<pointer_size> BasicEEPROM_25xx<Traits, Backend, Stats>::tryWriteByteArray(const_type<pointer_size> address, std::span<const byte> data, const_type<WriteMode> mode) const noexcept {
+        return measure(OP_WRITE_BYTE_ARRAY, data.size(), [&]() noexcept -> Result<pointer_size> {
+            if (data.empty())
+                return ERROR_INVALID_ARGUMENT;
+            if (const Result<void> result = validate(address); !result)
+                return result.error();
+
+            if (mode == WRITE_ALWAYS) {
+                if (const Result<pointer_size> result = writeBursts(address, data.data(), data.size(), nullptr); !result)
+                    return result;
+                if (const Result<void> result = settle(); !result)
+                    return result.error();
+                return pointer_size{0};
+            }
+
+            // Only the last device size of bytes defines final content
+            const array_size skip = data.size() > CAPACITY ? data.size() - CAPACITY : 0;
+            const pointer_size start = (address + skip) % CAPACITY;
+            const array_size count = data.size() - skip;
+
+            // Range is compared window by window
+            byte current[BUFFER_SIZE];
+            pointer_size skipped = 0;
+            array_size done = 0;
+            while (done < count) {
+                const pointer_size position = (start + done) % CAPACITY;
+                const array_size window = windowSize(position, count - done);
+
+                if (const Result<void> result = tryReadInto(position, std::span<byte>(current, window)); !result)
+                    return result.error();
+                const Result<pointer_size> result = writeBursts(position, data.data() + skip + done, window, current);
+                if (!result)
+                    return result;
+                skipped += result.value();
+
+                done += window;
+            }
+            if (const Result<void> result = settle(); !result)
+                return result.error();
+            return skipped;
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    typename BasicEEPROM_25xx<Traits, Backend, Stats>::WriteFuture BasicEEPROM_25xx<Traits, Backend, Stats>::writeAsync(const_type<pointer_size> address, std::span<const byte> data) const {
+        const Result<WriteFuture> result = tryWriteAsync(address, data);
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::writeAsync()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<typename BasicEEPROM_25xx<Traits, Backend, Stats>::WriteFuture> BasicEEPROM_25xx<Traits, Backend, Stats>::tryWriteAsync(const_type<pointer_size> address, std::span<const byte> data) const noexcept {
+        return measure(OP_WRITE_ASYNC, data.size(), [&]() noexcept -> Result<WriteFuture> {
+            if (data.empty())
+                return ERROR_INVALID_ARGUMENT;
+            if (const Result<void> result = validate(address); !result)
+                return result.error();
+
+            if (const Result<pointer_size> result = writeBursts(address, data.data(), data.size(), nullptr); !result)
+                return result.error();
+            return WriteFuture(this, issued);
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    BasicEEPROM_25xx<Traits, Backend, Stats>::WriteFuture::WriteFuture(const BasicEEPROM_25xx* eeprom, const_type<dword> sequence) noexcept : eeprom(eeprom), sequence(sequence) {}
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    bool BasicEEPROM_25xx<Traits, Backend, Stats>::WriteFuture::ready() const {
+        const Result<bool> result = tryReady();
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::WriteFuture::ready()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<bool> BasicEEPROM_25xx<Traits, Backend, Stats>::WriteFuture::tryReady() const noexcept {
+        if (eeprom->completed >= sequence)
+            return true;
+
+        // Every burst waits for the previous one, so only the last issued burst may be in progress
+        const Result<byte> status = eeprom->tryReadStatus();
+        if (!status)
+            return status.error();
+        if (status.value() & SR_WIP)
+            return false;
+        eeprom->completed = eeprom->issued;
+        return true;
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::WriteFuture::wait() const {
+        if (const Result<void> result = tryWait(); !result)
+            throwError(result.error(), "EEPROM_25xx::WriteFuture::wait()");
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::WriteFuture::tryWait() const noexcept {
+        if (eeprom->completed >= sequence)
+            return {};
+
+        return eeprom->settle();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    inline void BasicEEPROM_25xx<Traits, Backend, Stats>::stop() noexcept {
+        isWorking = false;
+    }
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    inline void BasicEEPROM_25xx<Traits, Backend, Stats>::resume() noexcept {
+        isWorking = true;
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    const Stats& BasicEEPROM_25xx<Traits, Backend, Stats>::getStats() const noexcept {
+        return stats;
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::resetStats() const noexcept {
+        if constexpr (requires { stats.reset(); })
+            stats.reset();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    inline Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::validate(const_type<pointer_size> address) const noexcept {
+        if (!spi)
+            return ERROR_NO_BACKEND;
+        if (address > MAX_ADDRESS)
+            return ERROR_OUT_OF_RANGE;
+        if (!isWorking)
+            return ERROR_STOPPED;
+        return {};
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    byte BasicEEPROM_25xx<Traits, Backend, Stats>::readStatus() const {
+        const Result<byte> result = tryReadStatus();
+        if (!result)
+            throwError(result.error(), "EEPROM_25xx::readStatus()");
+
+        return result.value();
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<byte> BasicEEPROM_25xx<Traits, Backend, Stats>::tryReadStatus() const noexcept {
+        return measure(OP_READ_STATUS, 1, [&]() noexcept -> Result<byte> {
+            if (!spi)
+                return ERROR_NO_BACKEND;
+
+            // STATUS register is received right after instruction byte
+            byte arr[2] = {CMD_RDSR, 0};
+            if (const Result<void> result = transact(std::span<const byte>(arr, 1), arr); !result)
+                return result.error();
+
+            return arr[1];
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::writeStatus(const_type<byte> value) const {
+        if (const Result<void> result = tryWriteStatus(value); !result)
+            throwError(result.error(), "EEPROM_25xx::writeStatus()");
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::tryWriteStatus(const_type<byte> value) const noexcept {
+        return measure(OP_WRITE_STATUS, 1, [&]() noexcept -> Result<void> {
+            if (const Result<void> result = validate(0); !result)
+                return result;
+
+            // Write order is the one of page burst: device accepts CMD_WRSR only after CMD_WREN, WIP is set while bits are written
+            if (const Result<void> result = settle(); !result)
+                return result;
+
+            const byte wren = CMD_WREN;
+            if (const Result<void> result = transact(std::span<const byte>(&wren, 1), {}); !result)
+                return result;
+
+            const byte arr[2] = {CMD_WRSR, static_cast<byte>(value & (SR_BP0 | SR_BP1))};
+            if (const Result<void> result = transact(arr, {}); !result)
+                return result;
+            ++issued;
+            issuedAt = std::chrono::steady_clock::now();
+
+            return settle();
+        });
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    typename BasicEEPROM_25xx<Traits, Backend, Stats>::BlockProtection BasicEEPROM_25xx<Traits, Backend, Stats>::getBlockProtection() const {
+        return static_cast<BlockProtection>(readStatus() & (SR_BP0 | SR_BP1));
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    void BasicEEPROM_25xx<Traits, Backend, Stats>::setBlockProtection(const_type<BlockProtection> protection) const {
+        writeStatus(protection);
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    constexpr dword BasicEEPROM_25xx<Traits, Backend, Stats>::protectedFrom(const_type<BlockProtection> protection) noexcept {
+        switch (protection) {
+            case PROTECT_UPPER_QUARTER:
+                return CAPACITY - CAPACITY / 4;
+            case PROTECT_UPPER_HALF:
+                return CAPACITY / 2;
+            case PROTECT_ALL:
+                return 0;
+            default:
+                return CAPACITY;
+        }
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::waitWriteComplete() const noexcept {
+        using namespace std::chrono;
+        const auto deadline = issuedAt + WRITE_CYCLE_TIMEOUT;
+
+        // 1. Quick polls: cycle may be overlapped by caller's work or device may be faster than expected.
+        // Elapsed time is only the upper bound of cycle time then, so it may only lower the estimate
+        for (byte i = 0; i < QUICK_POLLS; ++i) {
+            const Result<byte> status = tryReadStatus();
+            if (!status)
+                return status.error();
+            if (status.value() & SR_WIP)
+                continue;
+
+            const nanoseconds observed = steady_clock::now() - issuedAt;
+            if (observed < writeCycleEstimate)
+                writeCycleEstimate = (writeCycleEstimate + observed) / 2;
+            return {};
+        }
+
+        // 2. Sleep till half of expected cycle, then poll with doubling interval starting from 1/16 of it
+        nanoseconds interval = writeCycleEstimate / 16 > POLL_INTERVAL_MIN ? writeCycleEstimate / 16 : nanoseconds{POLL_INTERVAL_MIN};
+        steady_clock::time_point wake = issuedAt + writeCycleEstimate / 2;
+        for (;;) {
+            if (steady_clock::now() < wake)
+                std::this_thread::sleep_until(wake);
+            const Result<byte> status = tryReadStatus();
+            if (!status)
+                return status.error();
+            if (!(status.value() & SR_WIP))
+                break;
+
+            const steady_clock::time_point now = steady_clock::now();
+            if (now > deadline)
+                return ERROR_TIMEOUT;
+            wake = now + interval;
+            interval = interval * 2 < POLL_INTERVAL_MAX ? interval * 2 : nanoseconds{POLL_INTERVAL_MAX};
+        }
+
+        // Completion is observed within single interval: estimate follows real cycle time both ways
+        writeCycleEstimate = (writeCycleEstimate + (steady_clock::now() - issuedAt)) / 2;
+        return {};
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::settle() const noexcept {
+        if (completed == issued)
+            return {};
+
+        const typename Stats::Token token = stats.enter(OP_WRITE_CYCLE);
+        const Result<void> result = waitWriteComplete();
+        stats.leave(token, result.ok(), 0);
+        if (!result)
+            return result;
+        completed = issued;
+        return {};
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::writePage(const_type<pointer_size> address, const byte* data, const_type<pointer_size> length) const noexcept {
+        // Write order:
+        // 1. Set CS low.
+        // 2. Push CMD_WREN instruction.
+        // 3. Set CS high (WEL is latched).
+        // 4. Set CS low.
+        // 5. Push CMD_WRITE instruction with data (no more than till the end of the page).
+        // 6. Set CS high (write cycle starts).
+        // 7. Poll STATUS register unless WIP is cleared. WEL is reset by device after write cycle.
+        // Polling is deferred until the next instruction (see BasicEEPROM_25xx::settle), so write cycle of previous burst is awaited first.
+        if (const Result<void> result = settle(); !result)
+            return result;
+
+        // 1. Enable writing. Instruction has no address
+        const byte wren = CMD_WREN;
+        if (const Result<void> result = transact(std::span<const byte>(&wren, 1), {}); !result)
+            return result;
+
+        // 2. Write page burst: data follows instruction in the same frame
+        byte arr[Traits::INSTRUCTION_SIZE + PAGE_SIZE];
+        Traits::encodeInstruction(arr, CMD_WRITE, address);
+        std::memcpy(arr + Traits::INSTRUCTION_SIZE, data, length);
+
+        if (const Result<void> result = transact(std::span<const byte>(arr, Traits::INSTRUCTION_SIZE + length), {}); !result)
+            return result;
+        ++issued;
+        issuedAt = std::chrono::steady_clock::now();
+        return {};
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::readRun(std::span<const ReadSegment> segments, const byte* order, const_type<byte> count) const noexcept {
+        // Run is single frame: instruction of the first range, then ranges in address order.
+        // Gap is clocked into scratch. Range which starts inside already clocked bytes copies them from range which reaches the furthest:
+        // it starts no later, so it holds every clocked byte since the range start.
+        const ReadSegment& head = segments[order[0]];
+        byte instruction[Traits::INSTRUCTION_SIZE];
+        Traits::encodeInstruction(instruction, CMD_READ, head.address);
+
+        spi->chipDeselect();
+        TransferStatus status = spi->transfer(instruction, {});
+        dword position = head.address;
+        const ReadSegment* owner = &head;
+        byte scratch[PAGE_SIZE];
+        for (byte i = 0; i < count && status == TRANSFER_OK; ++i) {
+            const ReadSegment& segment = segments[order[i]];
+            while (position < segment.address && status == TRANSFER_OK) {
+                const array_size chunk = segment.address - position < PAGE_SIZE ? segment.address - position : PAGE_SIZE;
+                status = spi->transfer({}, std::span<byte>(scratch, chunk));
+                position += chunk;
+            }
+
+            const dword end = segment.address + segment.buffer.size();
+            if (segment.address < position)
+                std::memcpy(segment.buffer.data(), owner->buffer.data() + (segment.address - owner->address), (end < position ? end : position) - segment.address);
+            if (end > position && status == TRANSFER_OK) {
+                status = spi->transfer({}, segment.buffer.subspan(position - segment.address));
+                position = end;
+                owner = &segment;
+            }
+        }
+        spi->chipSelect();
+        stats.instruction(CMD_READ);
+
+        return toErrorCode(status);
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    template <typename Segment>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::sortSegments(std::span<const Segment> segments, byte* order) const noexcept {
+        if (segments.empty() || segments.size() > MAX_SEGMENTS)
+            return ERROR_INVALID_ARGUMENT;
+
+        for (byte i = 0; i < segments.size(); ++i) {
+            array_size size;
+            if constexpr (std::is_same_v<Segment, ReadSegment>)
+                size = segments[i].buffer.size();
+            else
+                size = segments[i].data.size();
+
+            if (!size)
+                return ERROR_INVALID_ARGUMENT;
+            if (const Result<void> result = validate(segments[i].address); !result)
+                return result;
+            if (size > CAPACITY - segments[i].address)
+                return ERROR_OUT_OF_RANGE;
+
+            // Insertion sort: ranges of equal address keep their order
+            byte j = i;
+            for (; j > 0 && segments[order[j - 1]].address > segments[i].address; --j)
+                order[j] = order[j - 1];
+            order[j] = i;
+        }
+        return {};
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<void> BasicEEPROM_25xx<Traits, Backend, Stats>::transact(std::span<const byte> tx, std::span<byte> rx) const noexcept {
+        // Instruction is the low bits of the first byte, address bits of 25xx instruction are above them
+        stats.instruction(tx[0]);
+
+        // Backend may execute whole frame itself, see ISpiBitBang::transact
+        if constexpr (requires { spi->transact(tx, rx); })
+            return toErrorCode(spi->transact(tx, rx));
+        else {
+            spi->chipDeselect();
+            const TransferStatus status = spi->transfer(tx, rx);
+            spi->chipSelect();
+            return toErrorCode(status);
+        }
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    template <typename Body>
+    auto BasicEEPROM_25xx<Traits, Backend, Stats>::measure(const_type<DriverOperation> operation, const_type<array_size> bytes, Body body) const noexcept {
+        const typename Stats::Token token = stats.enter(operation);
+        const auto result = body();
+        stats.leave(token, result.ok(), bytes);
+        return result;
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    array_size BasicEEPROM_25xx<Traits, Backend, Stats>::windowSize(const_type<pointer_size> address, const_type<array_size> remaining) noexcept {
+        // Window ends on BUFFER_SIZE boundary, which is page boundary too
+        const array_size room = BUFFER_SIZE - address % BUFFER_SIZE;
+        return remaining < room ? remaining : room;
+    }
+
+    template <typename Traits, SpiBackend Backend, typename Stats>
+    Result<pointer_size> BasicEEPROM_25xx<Traits, Backend, Stats>::writeBursts(const_type<pointer_size> address, const byte* data, const_type<array_size> length, const byte* current) const noexcept {
+        // Device wraps address inside page, so data is split into bursts which end on page boundary:
+        // first burst is from address to the end of its page, next ones are full pages, the last one is the rest.
+        pointer_size skipped = 0;
+        pointer_size position = address;
+        array_size written = 0;
+        while (written < length) {
+            const pointer_size room = PAGE_SIZE - position % PAGE_SIZE;
+            const pointer_size chunk = length - written < room ? length - written : room;
+
+            // memcmp is vectorised by standard library, so diff is negligible next to SPI transfer
+            if (current && !std::memcmp(current + written, data + written, chunk))
+                ++skipped;
+            else if (const Result<void> result = writePage(position, data + written, chunk); !result)
+                return result.error();
+
+            written += chunk;
+            position = (position + chunk) % CAPACITY;
+        }
+        return skipped;
+    }
+#endif
@@ -0,0 +1,407 @@
+/**
+* @file eeprom_25xx_scheduler.h
+* @brief Provides I/O scheduler of 25xx EEPROM shared by several threads: requests are queued lock-free, sorted by address, merged and coalesced by page.
+*/
+
+#ifndef EEPROM_25XX_SCHEDULER_H
+
+    /**
+    * @def EEPROM_25XX_SCHEDULER_H
+    * @brief Include module macro.
+    */
+    #define EEPROM_25XX_SCHEDULER_H
+
+    #include "eeprom_25lc040a.h"
+
+    #include <atomic>
+    #include <concepts>
+    #include <condition_variable>
+    #include <future>
+    #include <memory>
+    #include <mutex>
+    #include <stdexcept>
+    #include <thread>
+
+    /**
+    *   @concept VectoredStorage
+    *   @brief Requirements to storage driver used by BasicEEPROM_25xxScheduler. Every BasicEEPROM_25xx satisfies it.
+    */
+    template <typename T>
+    concept VectoredStorage = requires(const T& storage, std::span<const EEPROM_25xx::ReadSegment> reads, std::span<const EEPROM_25xx::WriteSegment> writes) {
+        { T::CAPACITY } -> std::convertible_to<dword>;
+        { T::MAX_SEGMENTS } -> std::convertible_to<byte>;
+        { storage.tryReadv(reads) } -> std::same_as<Result<dword>>;
+        { storage.tryWritev(writes) } -> std::same_as<Result<dword>>;
+    };
+
+    /**
+    * @class BasicEEPROM_25xxScheduler
+    * @tparam Driver storage driver. See ::VectoredStorage.
+    * @brief I/O scheduler which owns device access: any thread submits reads and writes, single worker thread executes them.
+    *
+    * Requests are pushed into lock-free stack (multiple producers, single consumer: worker), the worker takes all of them at once as batch.
+    * Batch is split into epochs in arrival order, so request never observes requests submitted after it:
+    * epoch ends before write which overlaps earlier read of epoch, or when reads or writes reach <TT>Driver::MAX_SEGMENTS</TT>.
+    * Writes of epoch are applied to device image in arrival order (the latest write of byte wins), collected into sorted ranges and written by
+    * BasicEEPROM_25xx::writev: writes of the same page share single page burst, one WREN and one write cycle.
+    * Then reads of epoch are executed by BasicEEPROM_25xx::readv: sorted by address and merged into runs read by single frame.
+    * Device has no head to move, so elevator order is single ascending sweep per epoch: its gain is merging.
+    * @warning Driver must not be used by others while scheduler lives. Buffers and data of request must live until its future is ready.
+    */
+    template <VectoredStorage Driver>
+    class BasicEEPROM_25xxScheduler {
+    public:
+	/**
+	* @param eeprom driver of device.
+	* @throw std::invalid_argument if eeprom == nullptr.
+	* @brief Constructs scheduler and starts worker thread.
+	*/
+        explicit BasicEEPROM_25xxScheduler(const Driver* eeprom);
+
+	/**
+	* @brief Executes queued requests and stops worker thread. No request may be submitted meanwhile.
+	*/
+        ~BasicEEPROM_25xxScheduler();
+
+        BasicEEPROM_25xxScheduler(const BasicEEPROM_25xxScheduler&) = delete;
+        BasicEEPROM_25xxScheduler& operator=(const BasicEEPROM_25xxScheduler&) = delete;
+
+	/**
+	* @param address address to read from.
+	* @param buffer buffer to fill. Its size is bytes count to read.
+	* @return future of result:
+	* - ErrorCode::ERROR_INVALID_ARGUMENT if buffer is empty.
+	* - ErrorCode::ERROR_OUT_OF_RANGE range exceeds device. Ranges don't wrap.
+	* - See BasicEEPROM_25xx::tryReadv for other error codes.
+	* @brief Queue read. Invalid request is not queued: its future is ready at once.
+	*/
+        std::future<Result<void>> read(const_type<pointer_size> address, std::span<byte> buffer);
+
+	/**
+	* @param address address to write to.
+	* @param data bytes to write.
+	* @return future of result. See BasicEEPROM_25xxScheduler::read and BasicEEPROM_25xx::tryWritev for error codes.
+	* @brief Queue write. Invalid request is not queued: its future is ready at once.
+	*/
+        std::future<Result<void>> write(const_type<pointer_size> address, std::span<const byte> data);
+
+	/**
+	* @return count of queued requests.
+	*/
+        dword getRequestCount() const noexcept;
+
+	/**
+	* @return count of batches taken by worker.
+	*/
+        dword getBatchCount() const noexcept;
+
+	/**
+	* @return count of epochs executed by worker: every epoch costs single BasicEEPROM_25xx::writev and single BasicEEPROM_25xx::readv at most.
+	*/
+        dword getEpochCount() const noexcept;
+
+    private:
+	/**
+	* @struct Request
+	* @brief Queued request. Allocated by submitting thread, deleted by worker once its future is ready.
+	*/
+        struct Request {
+            pointer_size address; ///< Address of range.
+            std::span<byte> buffer; ///< Buffer of read. Empty for write.
+            std::span<const byte> data; ///< Data of write. Empty for read.
+            std::promise<Result<void>> promise{}; ///< Result of request.
+            Request* next{nullptr}; ///< Next queued request.
+        };
+
+	/**
+	* @enum ByteState
+	* @brief Bits of BasicEEPROM_25xxScheduler::state: how byte is used by current epoch.
+	*/
+        enum ByteState : byte {
+            BYTE_WRITTEN = 0b01, ///< Byte is written by epoch, image holds its value.
+            BYTE_READ = 0b10 ///< Byte is read by epoch.
+        };
+
+	/**
+	* @brief Driver of device.
+	*/
+        const Driver* eeprom;
+
+	/**
+	* @brief Lock-free stack of queued requests (multiple producers, single consumer: worker).
+	*/
+        std::atomic<Request*> pending{nullptr};
+
+	/**
+	* @brief Guards sleep of worker. Producers take it only to wake worker when stack stops being empty.
+	*/
+        std::mutex lock;
+
+	/**
+	* @brief Wakes worker.
+	*/
+        std::condition_variable wake;
+
+	/**
+	* @brief Whether worker must stop once stack is empty. Guarded by BasicEEPROM_25xxScheduler::lock.
+	*/
+        bool stopping{false};
+
+	/**
+	* @brief Count of queued requests.
+	*/
+        std::atomic<dword> requests{0};
+
+	/**
+	* @brief Count of taken batches.
+	*/
+        std::atomic<dword> batches{0};
+
+	/**
+	* @brief Count of executed epochs.
+	*/
+        std::atomic<dword> epochs{0};
+
+	/**
+	* @brief Image of bytes written by current epoch. Used by worker only.
+	*/
+        std::unique_ptr<byte[]> image;
+
+	/**
+	* @brief State of every byte of device in current epoch, see BasicEEPROM_25xxScheduler::ByteState. Used by worker only.
+	*/
+        std::unique_ptr<byte[]> state;
+
+	/**
+	* @brief Worker thread. The last member: it starts when everything else is constructed.
+	*/
+        std::thread worker;
+
+	/**
+	* @param request request to queue.
+	* @return future of request.
+	* @brief Validate and queue request, wake worker if stack was empty.
+	*/
+        std::future<Result<void>> submit(std::unique_ptr<Request> request);
+
+	/**
+	* @brief Worker loop: take batches until scheduler stops.
+	*/
+        void run() noexcept;
+
+	/**
+	* @param queue requests of batch in arrival order.
+	* @brief Split batch into epochs and execute them.
+	*/
+        void execute(Request* queue) noexcept;
+
+	/**
+	* @param first the first request of epoch.
+	* @param end request after the last one of epoch.
+	* @brief Write and read epoch, complete and delete its requests.
+	*/
+        void executeEpoch(Request* first, Request* end) noexcept;
+
+	/**
+	* @param address address of range.
+	* @param size count of bytes.
+	* @param flags state bits to test.
+	* @return whether some byte of range has any of @c flags.
+	*/
+        bool marked(const_type<pointer_size> address, const_type<array_size> size, const_type<byte> flags) const noexcept;
+    };
+
+    /**
+    * @typedef EEPROM_25LC040A_Scheduler
+    * @brief I/O scheduler of EEPROM_25LC040A.
+    */
+    using EEPROM_25LC040A_Scheduler = BasicEEPROM_25xxScheduler<EEPROM_25LC040A>;
+
+    template <VectoredStorage Driver>
+    BasicEEPROM_25xxScheduler<Driver>::BasicEEPROM_25xxScheduler(const Driver* eeprom)
+        : eeprom(eeprom), image(std::make_unique<byte[]>(Driver::CAPACITY)), state(std::make_unique<byte[]>(Driver::CAPACITY)) {
+        if (!eeprom)
+            throw std::invalid_argument("EEPROM_25xxScheduler::EEPROM_25xxScheduler(): \"eeprom\" is nullptr");
+
+        worker = std::thread([this] { run(); });
+    }
+
+    template <VectoredStorage Driver>
+    BasicEEPROM_25xxScheduler<Driver>::~BasicEEPROM_25xxScheduler() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    template <VectoredStorage Driver>
+    std::future<Result<void>> BasicEEPROM_25xxScheduler<Driver>::read(const_type<pointer_size> address, std::span<byte> buffer) {
+        return submit(std::unique_ptr<Request>(new Request{address, buffer, {}}));
+    }
+
+    template <VectoredStorage Driver>
+    std::future<Result<void>> BasicEEPROM_25xxScheduler<Driver>::write(const_type<pointer_size> address, std::span<const byte> data) {
+        return submit(std::unique_ptr<Request>(new Request{address, {}, data}));
+    }
+
+    template <VectoredStorage Driver>
+    dword BasicEEPROM_25xxScheduler<Driver>::getRequestCount() const noexcept {
+        return requests.load(std::memory_order_relaxed);
+    }
+
+    template <VectoredStorage Driver>
+    dword BasicEEPROM_25xxScheduler<Driver>::getBatchCount() const noexcept {
+        return batches.load(std::memory_order_relaxed);
+    }
+
+    template <VectoredStorage Driver>
+    dword BasicEEPROM_25xxScheduler<Driver>::getEpochCount() const noexcept {
+        return epochs.load(std::memory_order_relaxed);
+    }
+
+    template <VectoredStorage Driver>
+    std::future<Result<void>> BasicEEPROM_25xxScheduler<Driver>::submit(std::unique_ptr<Request> request) {
+        std::future<Result<void>> future = request->promise.get_future();
+        const array_size size = request->buffer.size() + request->data.size();
+        if (!size || request->address >= Driver::CAPACITY || size > Driver::CAPACITY - request->address) {
+            request->promise.set_value(!size ? ERROR_INVALID_ARGUMENT : ERROR_OUT_OF_RANGE);
+            return future;
+        }
+
+        // Node belongs to worker as soon as it is pushed: previous head is kept locally
+        Request* node = request.release();
+        Request* head = pending.load(std::memory_order_relaxed);
+        do
+            node->next = head;
+        while (!pending.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+        requests.fetch_add(1, std::memory_order_relaxed);
+
+        // Worker sleeps only on empty stack: the first request wakes it, the next ones are taken with it
+        if (!head) {
+            std::lock_guard<std::mutex> guard(lock);
+            wake.notify_one();
+        }
+        return future;
+    }
+
+    template <VectoredStorage Driver>
+    void BasicEEPROM_25xxScheduler<Driver>::run() noexcept {
+        for (;;) {
+            Request* stack = pending.exchange(nullptr, std::memory_order_acquire);
+            if (!stack) {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [this] { return pending.load(std::memory_order_relaxed) || stopping; });
+                if (!pending.load(std::memory_order_relaxed))
+                    return;
+                continue;
+            }
+
+            // Stack is LIFO, so it is reversed to keep arrival order
+            Request* queue = nullptr;
+            while (stack) {
+                Request* next = stack->next;
+                stack->next = queue;
+                queue = stack;
+                stack = next;
+            }
+            batches.fetch_add(1, std::memory_order_relaxed);
+            execute(queue);
+        }
+    }
+
+    template <VectoredStorage Driver>
+    void BasicEEPROM_25xxScheduler<Driver>::execute(Request* queue) noexcept {
+        // Writes of epoch go before its reads: read after write of epoch sees new data, while write after read of the same bytes starts new epoch
+        while (queue) {
+            byte reads = 0;
+            byte writes = 0;
+            Request* end = queue;
+            for (; end; end = end->next) {
+                if (!end->data.empty()) {
+                    if (writes == Driver::MAX_SEGMENTS || marked(end->address, end->data.size(), BYTE_READ))
+                        break;
+                    std::memset(state.get() + end->address, BYTE_WRITTEN, end->data.size());
+                    ++writes;
+                } else {
+                    if (reads == Driver::MAX_SEGMENTS)
+                        break;
+                    for (array_size i = 0; i < end->buffer.size(); ++i)
+                        state[end->address + i] |= BYTE_READ;
+                    ++reads;
+                }
+            }
+
+            executeEpoch(queue, end);
+            queue = end;
+        }
+    }
+
+    template <VectoredStorage Driver>
+    void BasicEEPROM_25xxScheduler<Driver>::executeEpoch(Request* first, Request* end) noexcept {
+        epochs.fetch_add(1, std::memory_order_relaxed);
+
+        // 1. Writes are applied to image in arrival order and collected into sorted ranges of written bytes
+        EEPROM_25xx::WriteSegment writes[Driver::MAX_SEGMENTS];
+        byte writeCount = 0;
+        dword low = Driver::CAPACITY;
+        dword high = 0;
+        for (Request* request = first; request != end; request = request->next) {
+            if (request->data.empty())
+                continue;
+            std::memcpy(image.get() + request->address, request->data.data(), request->data.size());
+            low = request->address < low ? request->address : low;
+            high = request->address + request->data.size() > high ? request->address + request->data.size() : high;
+        }
+        for (dword address = low; address < high;) {
+            if (!(state[address] & BYTE_WRITTEN)) {
+                ++address;
+                continue;
+            }
+            dword to = address;
+            while (to < high && state[to] & BYTE_WRITTEN)
+                ++to;
+            writes[writeCount++] = {static_cast<pointer_size>(address), std::span<const byte>(image.get() + address, to - address)};
+            address = to;
+        }
+        Result<void> written{};
+        if (writeCount)
+            if (const Result<dword> result = eeprom->tryWritev(std::span<const EEPROM_25xx::WriteSegment>(writes, writeCount)); !result)
+                written = result.error();
+
+        // 2. Reads are sorted and merged by driver
+        EEPROM_25xx::ReadSegment reads[Driver::MAX_SEGMENTS];
+        byte readCount = 0;
+        for (Request* request = first; request != end; request = request->next)
+            if (request->data.empty())
+                reads[readCount++] = {request->address, request->buffer};
+        Result<void> read{};
+        if (readCount)
+            if (const Result<dword> result = eeprom->tryReadv(std::span<const EEPROM_25xx::ReadSegment>(reads, readCount)); !result)
+                read = result.error();
+
+        // 3. State is cleared for the next epoch, requests are completed
+        for (Request* request = first; request != end;) {
+            Request* next = request->next;
+            const array_size size = request->buffer.size() + request->data.size();
+            std::memset(state.get() + request->address, 0, size);
+            request->promise.set_value(request->data.empty() ? read : written);
+            delete request;
+            request = next;
+        }
+    }
+
+    template <VectoredStorage Driver>
+    bool BasicEEPROM_25xxScheduler<Driver>::marked(const_type<pointer_size> address, const_type<array_size> size, const_type<byte> flags) const noexcept {
+        for (array_size i = 0; i < size; ++i)
+            if (state[address + i] & flags)
+                return true;
+        return false;
+    }
+
+    /**
+    * @brief Scheduler of EEPROM_25LC040A is instantiated once in eeprom_25xx_scheduler.cpp.
+    */
+    extern template class BasicEEPROM_25xxScheduler<EEPROM_25LC040A>;
+#endif
@@ -0,0 +1,206 @@
+/**
+* @file eeprom_25xx_stats.h
+* @brief Provides per-operation statistics of 25xx EEPROM driver: counters and latency histograms.
+*/
+
+#ifndef EEPROM_25XX_STATS_H
+
+    /**
+    * @def EEPROM_25XX_STATS_H
+    * @brief Include module macro.
+    */
+    #define EEPROM_25XX_STATS_H
+
+    #include "spi_interface.h"
+
+    #include <array>
+    #include <atomic>
+    #include <chrono>
+
+    /**
+    * @enum DriverOperation
+    * @brief Operations of BasicEEPROM_25xx which statistics are collected. Throwing and exception-free variants of operation share statistics.
+    */
+    enum DriverOperation : byte {
+        OP_READ_BIT = 0, ///< BasicEEPROM_25xx::readBit.
+        OP_READ_BYTE, ///< BasicEEPROM_25xx::readByte.
+        OP_READ_INTO, ///< BasicEEPROM_25xx::readInto and BasicEEPROM_25xx::readByteArray.
+        OP_READ_BITS, ///< BasicEEPROM_25xx::readBits.
+        OP_WRITE_BIT, ///< BasicEEPROM_25xx::writeBit.
+        OP_WRITE_BYTE, ///< BasicEEPROM_25xx::writeByte.
+        OP_WRITE_BYTE_ARRAY, ///< BasicEEPROM_25xx::writeByteArray.
+        OP_WRITE_BITS, ///< BasicEEPROM_25xx::writeBits.
+        OP_WRITE_ASYNC, ///< BasicEEPROM_25xx::writeAsync.
+        OP_READ_STATUS, ///< BasicEEPROM_25xx::readStatus.
+        OP_WRITE_STATUS, ///< BasicEEPROM_25xx::writeStatus.
+        OP_READV, ///< BasicEEPROM_25xx::readv.
+        OP_WRITEV, ///< BasicEEPROM_25xx::writev.
+        OP_WRITE_CYCLE, ///< Wait for write cycle inside other operations. Counted even when nested.
+        OP_COUNT ///< Count of operations.
+    };
+
+    /**
+    * @param operation driver operation.
+    * @return name of @c operation, e.g. @c "readInto".
+    */
+    const char* describeOperation(const_type<DriverOperation> operation) noexcept;
+
+    /**
+    * @struct OperationStats
+    * @brief Snapshot of statistics of single operation. Counters wrap around on overflow.
+    */
+    struct OperationStats {
+        /**
+        * @brief Count of latency buckets: bucket @c i holds latencies of <TT>[2^(i-1); 2^i)</TT> nanoseconds, the last one holds longer ones too.
+        */
+        static constexpr byte LATENCY_BUCKETS = 32;
+
+        dword calls{0}; ///< Count of calls.
+        dword errors{0}; ///< Count of failed calls.
+        dword bytes{0}; ///< Count of device bytes read or written by successful calls.
+        dword transactions{0}; ///< Count of SPI frames issued by calls, frames of nested operations included.
+        std::array<dword, LATENCY_BUCKETS> latency{}; ///< Log-bucketed latency histogram.
+
+        /**
+        * @param quantile quantile in <TT>[0; 1]</TT>, e.g. 0.99.
+        * @return upper bound of latency bucket which holds @c quantile of calls, 0 if there are no calls.
+        */
+        std::chrono::nanoseconds percentile(const double quantile) const noexcept;
+    };
+
+    /**
+    * @struct DriverStatsSnapshot
+    * @brief Snapshot of every statistics of driver.
+    */
+    struct DriverStatsSnapshot {
+        std::array<OperationStats, OP_COUNT> operations{}; ///< Statistics indexed by ::DriverOperation.
+        std::array<dword, 8> instructions{}; ///< Count of frames indexed by instruction, e.g. EEPROM_25xx::CMD_WREN.
+    };
+
+    /**
+    * @class NoDriverStats
+    * @brief Statistics policy of BasicEEPROM_25xx which collects nothing. Every method is empty and inlined, token is empty,
+    * so driver compiles to the same code as without statistics.
+    */
+    class NoDriverStats {
+    public:
+	/**
+	* @struct Token
+	* @brief Empty token of operation.
+	*/
+        struct Token {};
+
+	/**
+	* @return empty token.
+	*/
+        Token enter(const_type<DriverOperation>) noexcept {
+            return {};
+        }
+
+	/**
+	* @brief Does nothing.
+	*/
+        void leave(const Token&, const_type<bit>, const_type<array_size>) noexcept {}
+
+	/**
+	* @brief Does nothing.
+	*/
+        void instruction(const_type<byte>) noexcept {}
+    };
+
+    /**
+    * @class DriverStats
+    * @brief Statistics policy of BasicEEPROM_25xx: per-operation calls, errors, bytes, SPI frames and latency histograms, frames per instruction.
+    *
+    * Only the outermost operation is counted: e.g. BasicEEPROM_25xx::readByte is not counted as BasicEEPROM_25xx::readInto too,
+    * frames of nested operations are attributed to the outermost one. Write cycle waits are counted as DriverOperation::OP_WRITE_CYCLE
+    * besides the operation which waits.
+    * Counters are lock-free atomics updated by relaxed load and store: driver is used by one thread at a time, while any thread may call
+    * DriverStats::snapshot concurrently. Snapshot is not atomic as whole, every counter is.
+    */
+    class DriverStats {
+    public:
+	/**
+	* @struct Token
+	* @brief Token of started operation.
+	*/
+        struct Token {
+            std::chrono::steady_clock::time_point start; ///< Time of operation start.
+            DriverOperation operation; ///< Operation.
+            bit counted; ///< Whether operation is counted: it is outermost one or write cycle wait.
+        };
+
+	/**
+	* @param operation started operation.
+	* @return token of operation for DriverStats::leave.
+	* @brief Start operation.
+	*/
+        Token enter(const_type<DriverOperation> operation) noexcept;
+
+	/**
+	* @param token token of DriverStats::enter.
+	* @param ok whether operation succeeded.
+	* @param bytes count of device bytes read or written.
+	* @brief Complete operation: count call, error or bytes and latency.
+	*/
+        void leave(const Token& token, const_type<bit> ok, const_type<array_size> bytes) noexcept;
+
+	/**
+	* @param command instruction of SPI frame, see EEPROM_25xx::Command.
+	* @brief Count frame issued by driver.
+	*/
+        void instruction(const_type<byte> command) noexcept;
+
+	/**
+	* @return snapshot of statistics. May be called by any thread.
+	*/
+        DriverStatsSnapshot snapshot() const noexcept;
+
+	/**
+	* @brief Reset every counter. Must be called by thread which uses driver.
+	*/
+        void reset() noexcept;
+
+    private:
+	/**
+	* @struct Counters
+	* @brief Lock-free counters of single operation.
+	*/
+        struct Counters {
+            std::atomic<dword> calls{0}; ///< See OperationStats::calls.
+            std::atomic<dword> errors{0}; ///< See OperationStats::errors.
+            std::atomic<dword> bytes{0}; ///< See OperationStats::bytes.
+            std::atomic<dword> transactions{0}; ///< See OperationStats::transactions.
+            std::array<std::atomic<dword>, OperationStats::LATENCY_BUCKETS> latency{}; ///< See OperationStats::latency.
+        };
+
+        static_assert(std::atomic<dword>::is_always_lock_free, "Driver statistics need lock-free counters");
+
+	/**
+	* @brief Counters indexed by ::DriverOperation.
+	*/
+        std::array<Counters, OP_COUNT> operations{};
+
+	/**
+	* @brief Frames indexed by instruction.
+	*/
+        std::array<std::atomic<dword>, 8> instructions{};
+
+	/**
+	* @brief Outermost operation in progress.
+	*/
+        DriverOperation current{OP_COUNT};
+
+	/**
+	* @brief Depth of nested operations in progress.
+	*/
+        byte depth{0};
+
+	/**
+	* @param counter counter to increment.
+	* @param value value to add.
+	* @brief Auxiliary method to add to counter of single writer without locked instruction.
+	*/
+        static void add(std::atomic<dword>& counter, const_type<dword> value = 1) noexcept;
+    };
+#endif
@@ -0,0 +1,323 @@
+/**
+* @file eeprom_25xx_streambuf.h
+* @brief Provides std::streambuf and std::iostream over region of 25xx EEPROM with page-sized get and put areas.
+*/
+
+#ifndef EEPROM_25XX_STREAMBUF_H
+
+    /**
+    * @def EEPROM_25XX_STREAMBUF_H
+    * @brief Include module macro.
+    */
+    #define EEPROM_25XX_STREAMBUF_H
+
+    #include "eeprom_25lc040a.h"
+
+    #include <concepts>
+    #include <istream>
+    #include <stdexcept>
+    #include <streambuf>
+
+    /**
+    *   @concept PagedStorage
+    *   @brief Requirements to storage driver used by BasicEEPROM_25xxStreambuf. Every BasicEEPROM_25xx satisfies it.
+    *   NorFlash doesn't: its page program only clears bits, so rewriting region needs sector erase, which put area of single page can't do.
+    */
+    template <typename T>
+    concept PagedStorage = requires(const T& storage, const pointer_size address, std::span<byte> buffer, std::span<const byte> data) {
+        { T::PAGE_SIZE } -> std::convertible_to<pointer_size>;
+        { T::MAX_ADDRESS } -> std::convertible_to<pointer_size>;
+        { storage.tryReadInto(address, buffer) } -> std::same_as<Result<void>>;
+        { storage.tryWriteByteArray(address, data) } -> std::same_as<Result<pointer_size>>;
+    };
+
+    /**
+    * @class BasicEEPROM_25xxStreambuf
+    * @tparam Driver storage driver. See ::PagedStorage.
+    * @brief Stream buffer over region of device. Single page-sized buffer works either as get area or as put area, like @c std::filebuf does:
+    * reads refill whole page at once, writes are collected till the end of page and written as single page burst,
+    * so streaming serializer hits bus at page granularity instead of per character. Input and output share single position.
+    *
+    * Put data reaches device on @c sync (<TT>std::ostream::flush</TT>), on seek, on the first read after writes, when put area reaches page end and in destructor.
+    * Device errors are reported as end of file, so stream sets @c badbit or @c failbit. Position beyond region is end of file too.
+    * @warning Stream buffer assumes it is the only writer of the region while put area is not empty.
+    * @note Only byte-rewritable EEPROM is supported, see ::PagedStorage.
+    */
+    template <PagedStorage Driver>
+    class BasicEEPROM_25xxStreambuf : public std::streambuf {
+    public:
+	/**
+	* @param eeprom driver of device.
+	* @param address address of region start.
+	* @param length count of bytes of region.
+	* @throw
+	* - std::invalid_argument if eeprom == nullptr or length is null.
+	* - std::out_of_range region exceeds device.
+	* @brief Constructs stream buffer. Position is region start, device is not accessed.
+	*/
+        explicit BasicEEPROM_25xxStreambuf(const Driver* eeprom, const_type<pointer_size> address = 0, const_type<array_size> length = array_size(Driver::MAX_ADDRESS) + 1);
+
+	/**
+	* @brief Writes put area. Errors are ignored, flush stream to handle them.
+	*/
+        ~BasicEEPROM_25xxStreambuf() override;
+
+        BasicEEPROM_25xxStreambuf(const BasicEEPROM_25xxStreambuf&) = delete;
+        BasicEEPROM_25xxStreambuf& operator=(const BasicEEPROM_25xxStreambuf&) = delete;
+
+    protected:
+	/**
+	* @returns current character or end of file.
+	* @brief Writes put area and reads page of current position.
+	*/
+        int_type underflow() override;
+
+	/**
+	* @param c character to put or end of file to write put area only.
+	* @returns @c c or end of file if put area isn't written or position is at region end.
+	* @brief Writes put area and starts new one from current position till the end of its page.
+	*/
+        int_type overflow(int_type c) override;
+
+	/**
+	* @returns 0 if put area is written, -1 otherwise.
+	*/
+        int sync() override;
+
+	/**
+	* @param offset offset from @c direction.
+	* @param direction origin of offset.
+	* @param mode ignored on purpose: input and output share single position like @c std::filebuf, so seek of either one moves both.
+	* @returns new position or <TT>pos_type(-1)</TT> if it is outside region or put area isn't written.
+	* @brief Move position. Asking current position (<TT>tellp</TT>, <TT>tellg</TT>) doesn't write put area, seek within get area doesn't read page again.
+	*/
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out) override;
+
+	/**
+	* @param position new position.
+	* @param mode ignored on purpose, see BasicEEPROM_25xxStreambuf::seekoff.
+	* @returns See BasicEEPROM_25xxStreambuf::seekoff.
+	*/
+        pos_type seekpos(pos_type position, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out) override;
+
+	/**
+	* @returns count of bytes till region end or -1 at region end.
+	*/
+        std::streamsize showmanyc() override;
+
+    private:
+	/**
+	* @brief Driver of device.
+	*/
+        const Driver* eeprom;
+
+	/**
+	* @brief Address of region start.
+	*/
+        pointer_size base;
+
+	/**
+	* @brief Count of bytes of region. Whole 64 KiB device doesn't fit in address word.
+	*/
+        array_size length;
+
+	/**
+	* @brief Region offset of buffer start.
+	*/
+        array_size window{0};
+
+	/**
+	* @brief Position when neither get area nor put area is set.
+	*/
+        array_size offset{0};
+
+	/**
+	* @brief Get or put area.
+	*/
+        char buffer[Driver::PAGE_SIZE];
+
+	/**
+	* @returns current position: region offset.
+	*/
+        array_size tell() const noexcept;
+
+	/**
+	* @param position region offset.
+	* @returns region offset of the end of page of @c position, region end at most.
+	*/
+        array_size pageEnd(const_type<array_size> position) const noexcept;
+
+	/**
+	* @returns whether put area is written.
+	* @brief Write put area as single page burst and drop both areas. Position is kept.
+	*/
+        bool flush() noexcept;
+    };
+
+    /**
+    * @class BasicEEPROM_25xxStream
+    * @tparam Driver storage driver. See ::PagedStorage.
+    * @brief @c std::iostream which owns BasicEEPROM_25xxStreambuf over region of device.
+    */
+    template <PagedStorage Driver>
+    class BasicEEPROM_25xxStream : public std::iostream {
+    public:
+	/**
+	* @param eeprom driver of device.
+	* @param address address of region start.
+	* @param length count of bytes of region.
+	* @throw See BasicEEPROM_25xxStreambuf::BasicEEPROM_25xxStreambuf.
+	* @brief Constructs stream.
+	*/
+        explicit BasicEEPROM_25xxStream(const Driver* eeprom, const_type<pointer_size> address = 0, const_type<array_size> length = array_size(Driver::MAX_ADDRESS) + 1);
+
+    private:
+	/**
+	* @brief Stream buffer.
+	*/
+        BasicEEPROM_25xxStreambuf<Driver> streambuf;
+    };
+
+    /**
+    * @typedef EEPROM_25LC040A_Streambuf
+    * @brief Stream buffer over EEPROM_25LC040A.
+    */
+    using EEPROM_25LC040A_Streambuf = BasicEEPROM_25xxStreambuf<EEPROM_25LC040A>;
+
+    /**
+    * @typedef EEPROM_25LC040A_Stream
+    * @brief Stream over EEPROM_25LC040A.
+    */
+    using EEPROM_25LC040A_Stream = BasicEEPROM_25xxStream<EEPROM_25LC040A>;
+
+    template <PagedStorage Driver>
+    BasicEEPROM_25xxStreambuf<Driver>::BasicEEPROM_25xxStreambuf(const Driver* eeprom, const_type<pointer_size> address, const_type<array_size> length)
+        : eeprom(eeprom), base(address), length(length) {
+        if (!eeprom)
+            throw std::invalid_argument("EEPROM_25xxStreambuf::EEPROM_25xxStreambuf(): \"eeprom\" is nullptr");
+        if (!length)
+            throw std::invalid_argument("EEPROM_25xxStreambuf::EEPROM_25xxStreambuf(): \"length\" is null");
+        if (address > Driver::MAX_ADDRESS || length > array_size(Driver::MAX_ADDRESS) + 1 - address)
+            throw std::out_of_range("EEPROM_25xxStreambuf::EEPROM_25xxStreambuf(): region exceeds device");
+    }
+
+    template <PagedStorage Driver>
+    BasicEEPROM_25xxStreambuf<Driver>::~BasicEEPROM_25xxStreambuf() {
+        flush();
+    }
+
+    template <PagedStorage Driver>
+    typename BasicEEPROM_25xxStreambuf<Driver>::int_type BasicEEPROM_25xxStreambuf<Driver>::underflow() {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (!flush() || offset >= length)
+            return traits_type::eof();
+
+        // Whole page of position is read, so reading back after seek within page is served from buffer
+        const array_size page = (base + offset) - (base + offset) % Driver::PAGE_SIZE;
+        const array_size start = page > base ? page - base : 0;
+        const array_size end = pageEnd(offset);
+        if (!eeprom->tryReadInto(pointer_size(base + start), std::span<byte>(reinterpret_cast<byte*>(buffer), end - start)))
+            return traits_type::eof();
+
+        window = start;
+        setg(buffer, buffer + (offset - start), buffer + (end - start));
+        return traits_type::to_int_type(*gptr());
+    }
+
+    template <PagedStorage Driver>
+    typename BasicEEPROM_25xxStreambuf<Driver>::int_type BasicEEPROM_25xxStreambuf<Driver>::overflow(int_type c) {
+        if (!flush())
+            return traits_type::eof();
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        if (offset >= length)
+            return traits_type::eof();
+
+        // Put area ends on page boundary: it is written as single page burst
+        window = offset;
+        setp(buffer, buffer + (pageEnd(offset) - offset));
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+
+    template <PagedStorage Driver>
+    int BasicEEPROM_25xxStreambuf<Driver>::sync() {
+        return flush() ? 0 : -1;
+    }
+
+    template <PagedStorage Driver>
+    typename BasicEEPROM_25xxStreambuf<Driver>::pos_type BasicEEPROM_25xxStreambuf<Driver>::seekoff(off_type offset, std::ios_base::seekdir direction, [[maybe_unused]] std::ios_base::openmode mode) {
+        // Serializers ask position often: put area is kept
+        if (direction == std::ios_base::cur && !offset)
+            return pos_type(off_type(tell()));
+
+        const array_size current = tell();
+        const off_type origin = direction == std::ios_base::beg ? 0 : direction == std::ios_base::cur ? current : length;
+        const off_type target = origin + offset;
+        if (target < 0 || target > static_cast<off_type>(length))
+            return pos_type(off_type(-1));
+
+        // Seek within get area keeps page read
+        if (eback() && target >= static_cast<off_type>(window) && target < static_cast<off_type>(window + (egptr() - eback()))) {
+            setg(eback(), eback() + (target - window), egptr());
+            return pos_type(target);
+        }
+        if (!flush())
+            return pos_type(off_type(-1));
+
+        this->offset = target;
+        return pos_type(target);
+    }
+
+    template <PagedStorage Driver>
+    typename BasicEEPROM_25xxStreambuf<Driver>::pos_type BasicEEPROM_25xxStreambuf<Driver>::seekpos(pos_type position, std::ios_base::openmode mode) {
+        return seekoff(off_type(position), std::ios_base::beg, mode);
+    }
+
+    template <PagedStorage Driver>
+    std::streamsize BasicEEPROM_25xxStreambuf<Driver>::showmanyc() {
+        const array_size position = tell();
+        return position < length ? std::streamsize(length - position) : -1;
+    }
+
+    template <PagedStorage Driver>
+    array_size BasicEEPROM_25xxStreambuf<Driver>::tell() const noexcept {
+        if (pbase())
+            return window + (pptr() - pbase());
+        if (eback())
+            return window + (gptr() - eback());
+        return offset;
+    }
+
+    template <PagedStorage Driver>
+    array_size BasicEEPROM_25xxStreambuf<Driver>::pageEnd(const_type<array_size> position) const noexcept {
+        const array_size end = (base + position) / Driver::PAGE_SIZE * Driver::PAGE_SIZE + Driver::PAGE_SIZE - base;
+        return end < length ? end : length;
+    }
+
+    template <PagedStorage Driver>
+    bool BasicEEPROM_25xxStreambuf<Driver>::flush() noexcept {
+        offset = tell();
+        const array_size count = pbase() ? pptr() - pbase() : 0;
+        setp(nullptr, nullptr);
+        setg(nullptr, nullptr, nullptr);
+        if (!count)
+            return true;
+
+        return eeprom->tryWriteByteArray(pointer_size(base + window), std::span<const byte>(reinterpret_cast<const byte*>(buffer), count)).ok();
+    }
+
+    template <PagedStorage Driver>
+    BasicEEPROM_25xxStream<Driver>::BasicEEPROM_25xxStream(const Driver* eeprom, const_type<pointer_size> address, const_type<array_size> length)
+        : std::iostream(nullptr), streambuf(eeprom, address, length) {
+        rdbuf(&streambuf);
+    }
+
+    /**
+    * @brief Stream buffer and stream over EEPROM_25LC040A are instantiated once in eeprom_25xx_streambuf.cpp.
+    */
+    extern template class BasicEEPROM_25xxStreambuf<EEPROM_25LC040A>;
+    extern template class BasicEEPROM_25xxStream<EEPROM_25LC040A>;
+#endif
@@ -0,0 +1,160 @@
+/** 
+* @file eeprom_25xx_traits.h
+* @brief Provides compile time description of 25xx SPI EEPROM parts.
+*/
+
+#ifndef EEPROM_25XX_TRAITS_H
+	
+    /**
+    * @def EEPROM_25XX_TRAITS_H
+    * @brief Include module macro.
+    */    
+    #define EEPROM_25XX_TRAITS_H
+
+    #include "spi_interface.h"
+
+    #include <chrono>
+
+    /**
+    * @typedef pointer_size
+    * @brief Size of pointer for 25xx EEPROM.
+    */
+    using pointer_size = word;
+
+    /**
+    * @class EEPROM_25xxTraits
+    * @tparam Capacity device size in bytes. Power of two, no more than 64 KiB.
+    * @tparam PageSize write page size in bytes. Power of two.
+    * @tparam AddressBits count of meaningful address bits.
+    * @tparam WriteCycleTime internal write cycle time (tWC) in microseconds.
+    * @brief Compile time description of 25xx SPI EEPROM part. Drives BasicEEPROM_25xx and BasicMockSpi, so every value is known at compile time.
+    *
+    * Instruction is encoded like datasheet byte stream: instruction byte is followed by address bytes.
+    * - up to 9 address bits: two bytes, <TT><b>0000 A8 ccc</b></TT> where "A8" is the 9th address bit and "ccc" is 3 bits command code, followed by <TT>A7-A0</TT>.
+    * - otherwise: three bytes, command code followed by big-endian 16 bits address.
+    * Instructions without address (EEPROM_25xx::CMD_WREN, EEPROM_25xx::CMD_RDSR and others) are single command code byte.
+    */
+    template <dword Capacity, pointer_size PageSize, byte AddressBits, dword WriteCycleTime>
+    struct EEPROM_25xxTraits {
+        static_assert(Capacity && !(Capacity & (Capacity - 1)) && Capacity <= 0x10000, "Capacity must be power of two no more than 64 KiB");
+        static_assert(PageSize && !(PageSize & (PageSize - 1)) && PageSize <= Capacity, "PageSize must be power of two no more than Capacity");
+        static_assert(Capacity <= dword{1} << AddressBits, "AddressBits are not enough to address Capacity");
+
+	/**
+	* @brief Device size in bytes.
+	*/
+        static constexpr dword CAPACITY = Capacity;
+
+	/**
+	* @brief Maximum address value for device.
+	*/
+        static constexpr pointer_size MAX_ADDRESS = Capacity - 1;
+
+	/**
+	* @brief Size of write page in bytes. Single CMD_WRITE instruction can't cross page boundary.
+	*/
+        static constexpr pointer_size PAGE_SIZE = PageSize;
+
+	/**
+	* @brief Count of meaningful address bits.
+	*/
+        static constexpr byte ADDRESS_BITS = AddressBits;
+
+	/**
+	* @brief Internal write cycle time (tWC) by datasheet.
+	*/
+        static constexpr std::chrono::microseconds WRITE_CYCLE_TIME{WriteCycleTime};
+
+	/**
+	* @brief Count of bytes of encoded instruction with address.
+	*/
+        static constexpr byte INSTRUCTION_SIZE = AddressBits <= 9 ? 2 : 3;
+
+	/**
+	* @param out buffer for INSTRUCTION_SIZE bytes.
+	* @param cmd command code. See EEPROM_25xx::Command.
+	* @param address address to execute command to.
+	* @brief Encode instruction.
+	*/
+        static constexpr void encodeInstruction(byte* out, const_type<byte> cmd, const_type<dword> address) noexcept {
+            if constexpr (INSTRUCTION_SIZE == 2) {
+                out[0] = cmd | (address & 0x100) >> 5;
+                out[1] = address & 0x00FF;
+            } else {
+                out[0] = cmd;
+                out[1] = (address & 0xFF00) >> 8;
+                out[2] = address & 0x00FF;
+            }
+        }
+
+	/**
+	* @param in INSTRUCTION_SIZE bytes of encoded instruction.
+	* @return command code. See EEPROM_25xx::Command.
+	* @brief Decode command code of instruction.
+	*/
+        static constexpr byte decodeCommand(const byte* in) noexcept {
+            return in[0] & 0x07;
+        }
+
+	/**
+	* @param in INSTRUCTION_SIZE bytes of encoded instruction.
+	* @return address limited by device capacity.
+	* @brief Decode address of instruction.
+	*/
+        static constexpr dword decodeAddress(const byte* in) noexcept {
+            if constexpr (INSTRUCTION_SIZE == 2)
+                return ((in[0] & 0x08) << 5 | in[1]) & MAX_ADDRESS;
+            else
+                return (in[1] << 8 | in[2]) & MAX_ADDRESS;
+        }
+    };
+
+    /**
+    * @typedef EEPROM_25LC040A_Traits
+    * @brief 25LC040A: 512 bytes, 16 bytes page, 9 bits address.
+    */
+    using EEPROM_25LC040A_Traits = EEPROM_25xxTraits<512, 16, 9, 5000>;
+
+    /**
+    * @typedef EEPROM_25LC080_Traits
+    * @brief 25LC080A: 1 KiB, 16 bytes page, 16 bits address.
+    */
+    using EEPROM_25LC080_Traits = EEPROM_25xxTraits<1024, 16, 16, 5000>;
+
+    /**
+    * @typedef EEPROM_25LC160_Traits
+    * @brief 25LC160A: 2 KiB, 16 bytes page, 16 bits address.
+    */
+    using EEPROM_25LC160_Traits = EEPROM_25xxTraits<2048, 16, 16, 5000>;
+
+    /**
+    * @typedef EEPROM_25LC320_Traits
+    * @brief 25LC320A: 4 KiB, 32 bytes page, 16 bits address.
+    */
+    using EEPROM_25LC320_Traits = EEPROM_25xxTraits<4096, 32, 16, 5000>;
+
+    /**
+    * @typedef EEPROM_25LC640_Traits
+    * @brief 25LC640A: 8 KiB, 32 bytes page, 16 bits address.
+    */
+    using EEPROM_25LC640_Traits = EEPROM_25xxTraits<8192, 32, 16, 5000>;
+
+    /**
+    * @typedef EEPROM_25LC128_Traits
+    * @brief 25LC128: 16 KiB, 64 bytes page, 16 bits address.
+    */
+    using EEPROM_25LC128_Traits = EEPROM_25xxTraits<16384, 64, 16, 5000>;
+
+    /**
+    * @typedef EEPROM_25LC256_Traits
+    * @brief 25LC256: 32 KiB, 64 bytes page, 16 bits address.
+    */
+    using EEPROM_25LC256_Traits = EEPROM_25xxTraits<32768, 64, 16, 5000>;
+
+    /**
+    * @typedef EEPROM_25LC512_Traits
+    * @brief 25LC512: 64 KiB, 128 bytes page, 16 bits address.
+    */
+    using EEPROM_25LC512_Traits = EEPROM_25xxTraits<65536, 128, 16, 5000>;
+
+#endif
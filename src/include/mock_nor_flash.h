@@ -0,0 +1,328 @@
+/**
+* @file mock_nor_flash.h
+* @brief SPI NOR flash mock implementation.
+*/
+
+#ifndef MOCK_NOR_FLASH_H
+
+    /**
+    * @def MOCK_NOR_FLASH_H
+    * @brief Include module macros.
+    */
+    #define MOCK_NOR_FLASH_H
+
+    #include "mock_storage.h"
+    #include "nor_flash.h"
+    #include "spi_interface.h"
+
+    #include <chrono>
+
+    /**
+    * @class MockNorFlash
+    * @brief SPI driver mock implementation. Emulates SPI NOR flash with 24 bits address and its program and erase timing on virtual clock.
+    * See @ref Mock_Nor_Flash_page "interaction manual".
+    */
+    class MockNorFlash final : public ISpiBitBang {
+    public:
+	/**
+	* @param capacity device size in bytes. Multiple of NorFlash::BLOCK_SIZE.
+	* @brief Constructs erased device.
+	*/
+        explicit MockNorFlash(const_type<dword> capacity = DEFAULT_CAPACITY);
+
+	/**
+	* @param image path to image file. File is created erased if it doesn't exist.
+	* @param capacity device size in bytes. Multiple of NorFlash::BLOCK_SIZE.
+	* @throw See MockStorage::MockStorage.
+	* @brief Constructs device with memory mapped image file. Device state is kept between runs and multi-megabyte images are opened without copying.
+	*/
+        MockNorFlash(const char* image, const_type<dword> capacity = DEFAULT_CAPACITY);
+
+	/**
+	* @brief Virtual destructor.
+	*/
+        ~MockNorFlash() = default;
+
+	/**
+	* @brief Sets SS level to high. Completes frame: latched program or erase instruction is started.
+	*/
+        void chipSelect() override;
+
+	/**
+	* @brief Sets SS level to low. Starts new frame. Pending program or erase advances virtual clock by real time bus was idle, till operation end at most.
+	*/
+        void chipDeselect() override;
+
+	/**
+	* @param data bit to send, most significant bit of byte goes first.
+	* @returns bit received, @c 0 if device is not selected.
+	* @brief Transfers single bit of current frame. Every 8 bits are passed to device as one byte (see MockNorFlash::transfer). Never throws.
+	*/
+        virtual bit transferBit(const_type<bit> data) noexcept override;
+
+	/**
+	* @param data byte to send.
+	* @returns byte received, @c 0 if byte is not accepted (see MockNorFlash::transfer).
+	* @brief Transfers single byte of current frame. Never throws.
+	*/
+        virtual byte transferByte(const_type<byte> data) noexcept override;
+
+	/**
+	* @param tx bytes to send. See @ref Mock_Nor_Flash_page "frame format".
+	* @param rx buffer for response.
+	* @returns
+	* - TransferStatus::TRANSFER_OK if bytes are accepted.
+	* - TransferStatus::TRANSFER_INVALID_STATE if <TT>SS</TT>'s state is high.
+	* - TransferStatus::TRANSFER_DEVICE_BUSY if frame starts with instruction other than NorFlash::CMD_RDSR while program or erase is in progress.
+	* - TransferStatus::TRANSFER_INVALID_INSTRUCTION if frame starts with unknown command code.
+	* @brief Clocks bytes of current frame. Frame may be split into any count of calls while SS is low.
+	*/
+        TransferStatus transfer(std::span<const byte> tx, std::span<byte> rx) noexcept override;
+
+	/**
+	* @brief Debugging method to get byte array by given @c memory address.
+	* @param address @c memory address to get pointer array from.
+	* @returns
+	* - @c nullptr if @c address is not less than device capacity.
+	* - @c pointer to requested segment.
+	*/
+        const byte* getByteArrayByAddress(const_type<flash_address> address) const;
+
+	/**
+	* @brief Debugging method to set SPI clock period. Every clocked byte advances virtual clock by 8 periods.
+	* @param period SPI clock period.
+	*/
+        void setClockPeriod(const_type<std::chrono::nanoseconds> period) noexcept;
+
+	/**
+	* @brief Debugging method to set emulated operation times.
+	* @param pageProgram page program time (tPP).
+	* @param sectorErase 4 KiB sector erase time (tSE).
+	* @param blockErase 64 KiB block erase time (tBE).
+	* @param chipErase chip erase time (tCE).
+	*/
+        void setOperationTimes(const_type<std::chrono::microseconds> pageProgram, const_type<std::chrono::microseconds> sectorErase,
+                               const_type<std::chrono::microseconds> blockErase, const_type<std::chrono::microseconds> chipErase) noexcept;
+
+	/**
+	* @brief Debugging method to get virtual time passed since construction.
+	* @returns sum of clocked bytes time and time program and erase were pending while bus was idle.
+	*/
+        std::chrono::nanoseconds getElapsedTime() const noexcept;
+
+	/**
+	* @brief Debugging method to get count of started page programs.
+	*/
+        dword getProgramCount() const noexcept;
+
+	/**
+	* @brief Debugging method to get count of started erases of any granularity.
+	*/
+        dword getEraseCount() const noexcept;
+
+	/**
+	* @brief Default device size: 8 Mbit.
+	*/
+        static constexpr dword DEFAULT_CAPACITY = 1 << 20;
+
+	/**
+	* @brief Default SPI clock period: 50 MHz.
+	*/
+        static constexpr std::chrono::nanoseconds CLOCK_PERIOD{20};
+
+	/**
+	* @brief Default page program time (tPP) by datasheet.
+	*/
+        static constexpr std::chrono::microseconds PAGE_PROGRAM_TIME = NorFlash::PAGE_PROGRAM_TIME;
+
+	/**
+	* @brief Default sector erase time (tSE) by datasheet.
+	*/
+        static constexpr std::chrono::microseconds SECTOR_ERASE_TIME = NorFlash::SECTOR_ERASE_TIME;
+
+	/**
+	* @brief Default block erase time (tBE) by datasheet.
+	*/
+        static constexpr std::chrono::microseconds BLOCK_ERASE_TIME = NorFlash::BLOCK_ERASE_TIME;
+
+    private:
+	/**
+	* @brief Possible states of SS.
+	*/
+        enum PinState : byte {
+            LOW = 0, ///< Low level signal
+            HIGH = 1 ///< High level signal
+        };
+
+	/**
+	* @brief SS state.
+	*/
+        bit SS{HIGH};
+
+	/**
+	* @brief Command code of current frame.
+	*/
+        byte command{0};
+
+	/**
+	* @brief Count of bytes clocked in current frame.
+	*/
+        array_size position{0};
+
+	/**
+	* @brief Address of current frame.
+	*/
+        flash_address address{0};
+
+	/**
+	* @brief Result of current frame returned by every MockNorFlash::transfer call of it.
+	*/
+        TransferStatus frameStatus{TRANSFER_OK};
+
+	/**
+	* @brief Write Enable Latch.
+	*/
+        bit writeEnabled{false};
+
+	/**
+	* @brief Page buffer of NorFlash::CMD_PAGE_PROGRAM frame. Untouched bytes are 0xFF, so they don't change memory.
+	*/
+        byte latch[NorFlash::PAGE_SIZE];
+
+	/**
+	* @brief Whether any data byte is latched in current frame.
+	*/
+        bit latched{false};
+
+	/**
+	* @brief Bits of current byte received by MockNorFlash::transferBit.
+	*/
+        byte shifted{0};
+
+	/**
+	* @brief Count of bits of current byte received by MockNorFlash::transferBit.
+	*/
+        byte bits{0};
+
+	/**
+	* @brief Byte shifted out by MockNorFlash::transferBit.
+	*/
+        byte outgoing{0};
+
+	/**
+	* @brief Emulated memory storage.
+	*/
+        MockStorage memory;
+
+	/**
+	* @brief Time of one clocked byte.
+	*/
+        std::chrono::nanoseconds byteTime{CLOCK_PERIOD * 8};
+
+	/**
+	* @brief Emulated page program time.
+	*/
+        std::chrono::nanoseconds pageProgramTime{PAGE_PROGRAM_TIME};
+
+	/**
+	* @brief Emulated sector erase time.
+	*/
+        std::chrono::nanoseconds sectorEraseTime{SECTOR_ERASE_TIME};
+
+	/**
+	* @brief Emulated block erase time.
+	*/
+        std::chrono::nanoseconds blockEraseTime{BLOCK_ERASE_TIME};
+
+	/**
+	* @brief Emulated chip erase time. Block erase time of every block by default.
+	*/
+        std::chrono::nanoseconds chipEraseTime;
+
+	/**
+	* @brief Virtual clock.
+	*/
+        std::chrono::nanoseconds now{0};
+
+	/**
+	* @brief Virtual time point when current operation is completed.
+	*/
+        std::chrono::nanoseconds busyUntil{0};
+
+	/**
+	* @brief Real time point of the last frame end: bus is idle since it.
+	*/
+        std::chrono::steady_clock::time_point idleSince{std::chrono::steady_clock::now()};
+
+	/**
+	* @brief Count of started page programs.
+	*/
+        dword programs{0};
+
+	/**
+	* @brief Count of started erases.
+	*/
+        dword erases{0};
+
+	/**
+	* @returns whether program or erase is in progress.
+	* @brief Auxiliary method to check operation state.
+	*/
+        bool isBusy() const noexcept;
+
+	/**
+	* @return index of the first data byte in current frame for NorFlash::CMD_READ or NorFlash::CMD_FAST_READ frame, 0 for other frames.
+	* @brief Auxiliary method to find where data is streamed from.
+	*/
+        array_size data_start() const noexcept;
+
+	/**
+	* @returns byte which device sends back while the next byte of frame is clocked.
+	* @brief Auxiliary method to get response before byte is received: response never depends on byte it is clocked with.
+	*/
+        byte next_byte() const noexcept;
+
+	/**
+	* @param data received byte.
+	* @returns byte to send back.
+	* @brief Auxiliary method to handle single byte of frame.
+	*/
+        byte handle_byte(const_type<byte> data) noexcept;
+
+	/**
+	* @brief Auxiliary method to execute latched instruction when frame is completed.
+	*/
+        void handle_frame_end() noexcept;
+
+	/**
+	* @param start address of erased range start. Aligned to @c length.
+	* @param length count of bytes to erase.
+	* @param time emulated erase time.
+	* @brief Auxiliary method to erase range and start operation.
+	*/
+        void handle_erase(const_type<flash_address> start, const_type<dword> length, const_type<std::chrono::nanoseconds> time) noexcept;
+    };
+
+#endif
+
+/**
+* @page Mock_Nor_Flash_page MockNorFlash interaction manual
+*
+* @section mock_nor_flash_intro Introduction
+* MockNorFlash emulates SPI NOR flash on byte level: every byte clocked by MockNorFlash::transfer, MockNorFlash::transferByte or by 8 calls of MockNorFlash::transferBit is parsed as it arrives, so frame (bytes between chipDeselect and chipSelect calls) may be split into any count of transfers.
+*
+* @section mock_nor_flash_frames Frames
+* The first byte of frame is command code (see NorFlash::Command), address instructions are followed by 24 bits big-endian address.
+* - NorFlash::CMD_READ: data is clocked out starting from 5th byte of frame. NorFlash::CMD_FAST_READ: 5th byte is dummy, data starts from 6th byte. Reading wraps at the end of device and lasts unless SS is set high. Data of read frames is copied by MockStorage::read, not byte by byte.
+* - NorFlash::CMD_PAGE_PROGRAM: bytes after address are latched into page buffer (wrapping inside page) and programmed when SS is set high. Programming only clears bits.
+* - NorFlash::CMD_SECTOR_ERASE, NorFlash::CMD_BLOCK_ERASE: unit containing address is erased when SS is set high. NorFlash::CMD_CHIP_ERASE has no address.
+* - NorFlash::CMD_RDSR: STATUS register is clocked out from 2nd byte unless SS is set high.
+* - NorFlash::CMD_WREN, NorFlash::CMD_WRDI: latch is changed when SS is set high. Program and erase are ignored unless NorFlash::SR_WEL is set; it is reset when operation is started.
+*
+* @section mock_nor_flash_timing Timing
+* Mock has virtual clock (see MockNorFlash::getElapsedTime): every clocked byte advances it by 8 SPI clock periods. Started program or erase keeps NorFlash::SR_WIP set for emulated operation time. While it is pending, real time the host waits between frames advances virtual clock too (till operation end at most), so operation completes either by polling or by sleeping driver.
+* Throughput measured on virtual clock matches real device with the same timing regardless of host speed.
+*
+* @section mock_nor_flash_storage Storage
+* Memory is MockStorage: anonymous erased mapping by default or image file mapped by MockNorFlash::MockNorFlash(const char*, const_type<dword>).
+*/
@@ -0,0 +1,133 @@
+/**
+* @file mock_spi_bus.h
+* @brief Mock of shared SPI data lines with several chips and chip select lines.
+*/
+
+#ifndef MOCK_SPI_BUS_H
+
+    /**
+    * @def MOCK_SPI_BUS_H
+    * @brief Include module macros.
+    */
+    #define MOCK_SPI_BUS_H
+
+    #include "spi_bus.h"
+
+    #include <atomic>
+    #include <initializer_list>
+    #include <vector>
+
+    /**
+    * @class MockSpiBus
+    * @brief Mock of shared SPI data lines. Bytes are clocked to the chip which chip select line is active.
+    * Every chip is a mock device, e.g. MockSpi. Activating a line while other one is active is a bus collision and is counted.
+    */
+    class MockSpiBus final : public ISpiBitBang {
+    public:
+	/**
+	* @class Line
+	* @brief Chip select line of single chip on mock bus.
+	*/
+        class Line final : public IChipSelect {
+        public:
+	    /**
+	    * @param bus mock bus.
+	    * @param chip mock device connected to line.
+	    * @brief Constructs line.
+	    */
+            Line(MockSpiBus& bus, ISpiBitBang* chip) noexcept;
+
+	    /**
+	    * @brief Selects chip on bus and starts its frame.
+	    */
+            void activate() noexcept override;
+
+	    /**
+	    * @brief Ends frame of chip and releases bus.
+	    */
+            void deactivate() noexcept override;
+
+        private:
+	    /**
+	    * @brief Mock bus.
+	    */
+            MockSpiBus& bus;
+
+	    /**
+	    * @brief Mock device connected to line.
+	    */
+            ISpiBitBang* chip;
+        };
+
+	/**
+	* @param chips mock devices connected to bus. Device @c i is selected by MockSpiBus::line(i).
+	* @brief Constructs bus.
+	*/
+        MockSpiBus(std::initializer_list<ISpiBitBang*> chips);
+
+	/**
+	* @brief Shared data lines have no chip select: does nothing.
+	*/
+        void chipSelect() override;
+
+	/**
+	* @brief Shared data lines have no chip select: does nothing.
+	*/
+        void chipDeselect() override;
+
+	/**
+	* @param data bit to send.
+	* @returns bit received from selected chip.
+	* @throw std::runtime_error if no chip is selected (TransferStatus::TRANSFER_INVALID_STATE, see validateTransferStatus).
+	* @brief Clocks single bit of selected chip.
+	*/
+        bit transferBit(const_type<bit> data) override;
+
+	/**
+	* @param data byte to send.
+	* @returns byte received from selected chip.
+	* @throw std::runtime_error if no chip is selected (TransferStatus::TRANSFER_INVALID_STATE, see validateTransferStatus).
+	* @brief Clocks single byte of selected chip.
+	*/
+        byte transferByte(const_type<byte> data) override;
+
+	/**
+	* @param tx bytes to send.
+	* @param rx buffer for response.
+	* @returns
+	* - TransferStatus::TRANSFER_INVALID_STATE if no chip is selected.
+	* - status of selected chip otherwise.
+	* @brief Clocks bytes to selected chip.
+	*/
+        TransferStatus transfer(std::span<const byte> tx, std::span<byte> rx) noexcept override;
+
+	/**
+	* @param index index of chip given to constructor.
+	* @throw std::out_of_range if @c index is not less than chips count.
+	* @returns chip select line of chip.
+	*/
+        IChipSelect* line(const_type<dword> index);
+
+	/**
+	* @brief Debugging method to get count of line activations while other line was active.
+	*/
+        dword getCollisionCount() const noexcept;
+
+    private:
+	/**
+	* @brief Chip select lines. Size is fixed on construction, so pointers to lines stay valid.
+	*/
+        std::vector<Line> lines;
+
+	/**
+	* @brief Chip which line is active, @c nullptr if none.
+	*/
+        std::atomic<ISpiBitBang*> selected{nullptr};
+
+	/**
+	* @brief Count of bus collisions.
+	*/
+        std::atomic<dword> collisions{0};
+    };
+
+#endif
@@ -11,68 +11,92 @@
     */
     #define MOCK_SPI_DRIVER
 
-    #include "eeprom_25lc040a.h"
+    #include "eeprom_25xx.h"
+    #include "mock_storage.h"
     #include "spi_interface.h"
 
-    #include <unordered_map>
+    #include <chrono>
+    #include <cstring>
+    #include <initializer_list>
 
     /**
-    * @class MockSpi
-    * @brief SPI driver mock implementation. Emulates EEPROM memory type based 25LC040A microchip.
+    * @struct MockBusStats
+    * @brief Bus statistics of mock device on virtual clock. See @ref mock_spi_cost "cost model".
     */
-    class MockSpi : public ISpiBitBang {
+    struct MockBusStats {
+        dword transactions{0}; ///< Count of frames (chip select toggles).
+        dword clocks{0}; ///< Count of SCK clocks: 8 per clocked byte.
+        dword payload{0}; ///< Count of data bytes: read or written bytes, STATUS register.
+        std::chrono::nanoseconds busTime{0}; ///< Time bus is occupied: SCK clocks and chip select overhead.
+        std::chrono::nanoseconds busyTime{0}; ///< Time of started internal write cycles.
+    };
+
+    template <typename Traits>
+    class BasicMockSpiPins;
+
+    /**
+    * @class BasicMockSpi
+    * @tparam Traits emulated device description. See EEPROM_25xxTraits.
+    * @brief SPI driver mock implementation. Emulates EEPROM memory type based 25xx microchip described by @c Traits.
+    */
+    template <typename Traits>
+    class BasicMockSpi final : public ISpiBitBang {
     public:
 	/**
 	* @brief Default constructor.
 	*/
-        MockSpi() = default;
+        BasicMockSpi() = default;
+
+	/**
+	* @param image path to image file of <TT>Traits::CAPACITY</TT> bytes. File is created and zeroed if it doesn't exist.
+	* @throw See MockStorage::MockStorage.
+	* @brief Constructs mock with memory mapped image file. Device state is kept between runs.
+	*/
+        explicit BasicMockSpi(const char* image);
 
 	/**
 	* @brief Virtual destructor.
 	*/
-        ~MockSpi() = default;
+        ~BasicMockSpi() = default;
 
 	/**
-	* @brief Sets SS level to high.
+	* @brief Sets SS level to high. Completes frame: latched WREN, WRDI or write instruction is executed, frame is accounted on virtual clock.
 	*/
         void chipSelect() override;
 
 	/**
-	* @brief Sets SS level to low.
+	* @brief Sets SS level to low. Starts new frame.
 	*/
         void chipDeselect() override;
 
 	/**
-	* @throw NotImplementedException Method is not implemented.
-	* @brief Not implemented.
+	* @param data bit to send, most significant bit of byte goes first.
+	* @returns bit received, @c 0 if device is not selected.
+	* @brief Transfers single bit of current frame. Every 8 bits are passed to device as one byte (see BasicMockSpi::transfer). Never throws.
 	*/
-        virtual bit transferBit(const_type<bit> data) override;
+        virtual bit transferBit(const_type<bit> data) noexcept override;
 
 	/**
-	* @throw NotImplementedException Method is not implemented.
-	* @brief Not implemented.
+	* @param data byte to send.
+	* @returns byte received, @c 0 if byte is not accepted (see BasicMockSpi::transfer).
+	* @brief Transfers single byte of current frame. Never throws.
 	*/
-        virtual byte transferByte(const_type<byte> data) override;
+        virtual byte transferByte(const_type<byte> data) noexcept override;
 
 	/**
-	* @param data byte array to transfer. If pointer to not allocated memory is provided then undefined behaviour might be caused.
-	* @param length byte array length.
-	* @throw std::invalid_argument @c length is less than 2.
-	* @throw std::invalid_argument @c data is nullptr.
-	* @throw std::runtime_error <TT>SS</TT>'s state is high.
-	* @throw std::invalid_argument @c length is less than 4. Causes when <TT>read/write</TT> operation is in progress.
-	* @throw std::runtime_error Not enough free memory space to create byte array. Device has not got enough space to allocate for byte array while trying reading.
-	* @throw std::invalid_argument Given address is to read/write is greater than EEPROM_25LC040A::MAX_ADDRESS.
-	* @throw std::runtime_error Invalid instruction is provided. See @ref mock_spi_notes "valid commands".
+	* @param tx bytes to send. See @ref Mock_Spi_page "frame format".
+	* @param rx buffer for response. Read data starts right after instruction, STATUS register right after instruction byte.
 	* @returns
-	* - @c nullptr if @ref EEPROM_25LC040A::Command::CMD_WRITE is provided and writing is successful.
-	* - pointer to emulated @c memory if @ref EEPROM_25LC040A::Command::CMD_READ is provided and reading is successful. <b>NOTE</b>: byte_array must be released manually using free() or delete[].
-	* - @c nullptr if @ref EEPROM_25LC040A::Command::CMD_WREN or @ref EEPROM_25LC040A::Command::CMD_WRDI is provided.
+	* - TransferStatus::TRANSFER_OK if bytes are accepted. Not enabled writing is ignored like real device does.
+	* - TransferStatus::TRANSFER_INVALID_STATE if <TT>SS</TT>'s state is high.
+	* - TransferStatus::TRANSFER_DEVICE_BUSY if frame starts with instruction other than EEPROM_25xx::CMD_RDSR while write cycle is in progress.
+	* - TransferStatus::TRANSFER_INVALID_INSTRUCTION if frame starts with invalid instruction. See @ref mock_spi_notes "valid commands".
+	* @brief Clocks bytes of current frame. Bytes are parsed as they arrive, so frame may be split into any count of calls while SS is low.
 	*/
-        virtual byte_array transferBytes(const byte_array data, const_type<array_size> length) override;
+        TransferStatus transfer(std::span<const byte> tx, std::span<byte> rx) noexcept override;
 
 	/**
-	* @brief Debugging method to set accurate byte array data conviniently.
+	* @brief Debugging method to set accurate byte array data conviniently. Data is copied by MockStorage::write.
 	* @param address virtual @c memory address to write @c data at.
 	* @param data byte array to write.
 	* @param length count of bytes to write.
@@ -83,31 +107,209 @@
 	* @brief Debugging method to get byte array by given virtual @c memory address.
 	* @param address virtual memory @c address to get pointer array from.
 	* @returns
-	* - @c nullptr if @c address is greater than EEPROM_25LC040A::MAX_ADDRESS.
+	* - @c nullptr if @c address is greater than <TT>Traits::MAX_ADDRESS</TT>.
 	* - @c pointer to requested segment.
 	*/
         const byte_array getByteArrayByAddress(const_type<pointer_size> address) const;
 
+	/**
+	* @brief Debugging method to set emulated internal write cycle time (tWC).
+	* @param time write cycle duration. Zero completes write cycles instantly.
+	*/
+        void setWriteCycleTime(const_type<std::chrono::microseconds> time) noexcept;
+
+	/**
+	* @brief Debugging method to set SCK frequency of cost model.
+	* @param frequency SCK frequency in Hz.
+	*/
+        void setBusFrequency(const_type<dword> frequency) noexcept;
+
+	/**
+	* @brief Debugging method to set write cycle time (tWC) accounted on virtual clock. Unlike BasicMockSpi::setWriteCycleTime it doesn't make mock wait.
+	* @param time write cycle duration.
+	*/
+        void setSimulatedWriteCycleTime(const_type<std::chrono::microseconds> time) noexcept;
+
+	/**
+	* @brief Debugging method to get virtual time passed since construction or BasicMockSpi::resetBusStats.
+	* @returns bus time of every frame that doesn't overlap write cycle plus write cycle time.
+	*/
+        std::chrono::nanoseconds getElapsedTime() const noexcept;
+
+	/**
+	* @brief Debugging method to get cumulative bus statistics.
+	*/
+        const MockBusStats& getBusStats() const noexcept;
+
+	/**
+	* @brief Debugging method to get bus statistics of frames with given command.
+	* @param command command code. See EEPROM_25xx::Command.
+	*/
+        const MockBusStats& getBusStats(const_type<byte> command) const noexcept;
+
+	/**
+	* @brief Debugging method to reset bus statistics and virtual clock.
+	*/
+        void resetBusStats() noexcept;
+
+	/**
+	* @brief Debugging method to get count of started internal write cycles.
+	* @returns count of accepted EEPROM_25xx::CMD_WRITE and EEPROM_25xx::CMD_WRSR instructions.
+	*/
+        dword getWriteCycleCount() const noexcept;
+
+	/**
+	* @brief Default emulated internal write cycle time (tWC) by datasheet.
+	*/
+        static constexpr std::chrono::microseconds WRITE_CYCLE_TIME = Traits::WRITE_CYCLE_TIME;
+
+	/**
+	* @brief Default SCK frequency of cost model: maximum by 25LC040A datasheet.
+	*/
+        static constexpr dword BUS_FREQUENCY = 10000000;
+
+	/**
+	* @brief Chip select overhead of every frame by datasheet: CS setup (tCSS), hold (tCSH) and disable (tCS) times.
+	*/
+        static constexpr std::chrono::nanoseconds CS_TIME{200};
+
     private:
+	/**
+	* @brief Pin-level device clocks bytes of frame one by one and needs response before byte is received.
+	*/
+        friend class BasicMockSpiPins<Traits>;
+
+	/**
+	* @brief Count of bytes of encoded instruction.
+	*/
+        static constexpr byte INSTRUCTION_SIZE = Traits::INSTRUCTION_SIZE;
+
 	/**
 	* @brief SS state.
 	*/
         bit SS{LOW};
 
 	/**
-	* @brief Whether correct EEPROM_25LC040A::Command::CMD_WREN instruction is given.
+	* @brief Write Enable Latch.
 	*/
-        bit writeInitiated{false};
+	bit writeEnabled{false};
 
 	/**
-	* @brief Whether writing is allowed
+	* @brief Non-volatile bits of STATUS register: EEPROM_25xx::SR_BP0 and EEPROM_25xx::SR_BP1.
 	*/
-	bit writeEnabled{false};
+        byte protection{0};
+
+	/**
+	* @brief Bytes of instruction of current frame.
+	*/
+        byte instruction[INSTRUCTION_SIZE]{};
+
+	/**
+	* @brief Command code of current frame.
+	*/
+        byte command{0};
+
+	/**
+	* @brief Count of bytes clocked in current frame.
+	*/
+        array_size position{0};
+
+	/**
+	* @brief Address of current frame.
+	*/
+        pointer_size address{0};
+
+	/**
+	* @brief Result of current frame returned by every BasicMockSpi::transfer call of it.
+	*/
+        TransferStatus frameStatus{TRANSFER_OK};
+
+	/**
+	* @brief Page buffer of EEPROM_25xx::CMD_WRITE frame. Filled with page content on the first data byte, so untouched bytes are kept.
+	* The first byte keeps STATUS register value of EEPROM_25xx::CMD_WRSR frame.
+	*/
+        byte latch[Traits::PAGE_SIZE];
+
+	/**
+	* @brief Bits of current byte received by BasicMockSpi::transferBit.
+	*/
+        byte shifted{0};
+
+	/**
+	* @brief Count of bits of current byte received by BasicMockSpi::transferBit.
+	*/
+        byte bits{0};
+
+	/**
+	* @brief Byte shifted out by BasicMockSpi::transferBit.
+	*/
+        byte outgoing{0};
+
+	/**
+	* @brief Whether any data byte is latched in current frame.
+	*/
+        bit latched{false};
+
+	/**
+	* @brief Emulated internal write cycle time.
+	*/
+        std::chrono::microseconds writeCycleTime{WRITE_CYCLE_TIME};
+
+	/**
+	* @brief Time point when current write cycle is completed.
+	*/
+        std::chrono::steady_clock::time_point busyUntil{};
+
+	/**
+	* @brief Count of started write cycles.
+	*/
+        dword writeCycles{0};
+
+	/**
+	* @brief Time of single SCK clock.
+	*/
+        std::chrono::nanoseconds clockTime{1000000000 / BUS_FREQUENCY};
+
+	/**
+	* @brief Write cycle time accounted on virtual clock.
+	*/
+        std::chrono::nanoseconds simulatedWriteCycleTime{WRITE_CYCLE_TIME};
+
+	/**
+	* @brief Virtual clock.
+	*/
+        std::chrono::nanoseconds elapsed{0};
+
+	/**
+	* @brief Virtual time point when current write cycle is completed.
+	*/
+        std::chrono::nanoseconds simulatedBusyUntil{0};
+
+	/**
+	* @brief Data bytes of current frame: read or written bytes, STATUS register.
+	*/
+        array_size payload{0};
+
+	/**
+	* @brief Cumulative bus statistics.
+	*/
+        MockBusStats total{};
+
+	/**
+	* @brief Bus statistics by command code.
+	*/
+        MockBusStats commands[8]{};
 
 	/**
 	* @brief Emulated memory storage for microchip.
 	*/
-        byte memory[EEPROM_25LC040A::MAX_ADDRESS + 1]{};
+        MockStorage memory{Traits::CAPACITY};
+
+	/**
+	* @returns whether internal write cycle is in progress.
+	* @brief Auxiliary method to check write cycle state.
+	*/
+        bool isBusy() const noexcept;
 
 	/**
 	* @brief Possible states of SS.
@@ -118,45 +320,368 @@
         };
 
 	/**
-	* @param address address of @c memory to read from.
-	* @param length byte count to read.
-	* @throw std::invalid_argument Given address is to read/write is greater than EEPROM_25LC040A::MAX_ADDRESS.
-	* @returns
-	* - @c nullptr if length == 0.
-	* - pointer to emulated @c memory.
-	* @warning if <TT>address + length > EEPROM_25LC040A::MAX_ADDRESS</TT>. When internal "pointer" of reading data from @c memory will reach <TT>EEPROM_25LC040A::MAX_ADDRESS + 1</TT> "pointer" will be assigned @c NULL and will continue reading unless all requested data is read.	
-	* @brief Auxiliary method to handle read command
+	* @param data received byte.
+	* @returns byte to send back.
+	* @brief Auxiliary method to handle single byte of frame.
 	*/
-        byte_array handle_read_command(const_type<pointer_size> address, pointer_size length) const;
+        byte handle_byte(const_type<byte> data) noexcept;
 
 	/**
-	* @param address address of @c memory to write.
-	* @param data byte array to write.
-	* @param length byte count to write.
-	* @throw std::invalid_argument Given address is to read/write is greater than EEPROM_25LC040A::MAX_ADDRESS.
-	* @warning if <TT>address + length > EEPROM_25LC040A::MAX_ADDRESS</TT>. When internal "pointer" of write data from @c memory will reach <TT>EEPROM_25LC040A::MAX_ADDRESS + 1</TT> "pointer" will be assigned @c NULL and will continue writing unless all given data is written.
-	* @brief Auxiliary method to handle read command.
+	* @param response buffer to fill by read data.
+	* @warning When internal "pointer" of reading data from @c memory will reach <TT>Traits::CAPACITY</TT> "pointer" will be assigned @c NULL and will continue reading unless all requested data is read.
+	* @brief Auxiliary method to stream the rest of transfer of EEPROM_25xx::CMD_READ frame. Data doesn't depend on sent bytes, so it is copied at once.
 	*/
-        void handle_write_command(const_type<pointer_size> address, const byte_array data, array_size length);
+        void handle_read_command(std::span<byte> response) noexcept;
+
+	/**
+	* @warning Internal "pointer" wraps inside page (see <TT>Traits::PAGE_SIZE</TT>) like real device does: when it reaches the end of the page it is assigned to the beginning of the same page and previously written bytes are overwritten.
+	* @brief Auxiliary method to execute latched instruction when frame is completed. Latched page burst starts internal write cycle.
+	*/
+        void handle_frame_end() noexcept;
+
+	/**
+	* @returns the lowest address protected by EEPROM_25xx::SR_BP0 and EEPROM_25xx::SR_BP1, <TT>Traits::CAPACITY</TT> if nothing is protected.
+	*/
+        dword protected_from() const noexcept;
+
+	/**
+	* @returns byte which is clocked out while the next byte of current frame is received.
+	* @brief Auxiliary method for pin-level device. Response never depends on byte received at the same time, so it is known in advance.
+	*/
+        byte next_byte() const noexcept;
     };
 
+    /**
+    * @typedef MockSpi
+    * @brief Mock of 25LC040A microchip.
+    */
+    using MockSpi = BasicMockSpi<EEPROM_25LC040A_Traits>;
+
+    template <typename Traits>
+    BasicMockSpi<Traits>::BasicMockSpi(const char* image) : memory(image, Traits::CAPACITY) {}
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::chipSelect() {
+        if (SS == LOW && position) {
+            const dword started = writeCycles;
+            handle_frame_end();
+
+            // Only STATUS polls overlap write cycle, any other frame starts after its end. Decision uses virtual clock only:
+            // it never goes backwards and doesn't depend on emulated real time write cycle
+            const std::chrono::nanoseconds cost = CS_TIME + clockTime * 8 * position;
+            if (command != EEPROM_25xx::CMD_RDSR && elapsed < simulatedBusyUntil)
+                elapsed = simulatedBusyUntil;
+            elapsed += cost;
+
+            std::chrono::nanoseconds busy{0};
+            if (writeCycles != started) {
+                busy = simulatedWriteCycleTime;
+                simulatedBusyUntil = elapsed + busy;
+            }
+
+            for (MockBusStats* stats : {&total, &commands[command]}) {
+                ++stats->transactions;
+                stats->clocks += position * 8;
+                stats->payload += payload;
+                stats->busTime += cost;
+                stats->busyTime += busy;
+            }
+        }
+        SS = HIGH;
+        position = 0;
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::chipDeselect() {
+        SS = LOW;
+        position = 0;
+        payload = 0;
+        latched = false;
+        frameStatus = TRANSFER_OK;
+        shifted = 0;
+        bits = 0;
+    }
+
+    template <typename Traits>
+    bit BasicMockSpi<Traits>::transferBit(const_type<bit> data) noexcept {
+        if (SS == HIGH)
+            return 0;
+
+        // Response byte is ready before its first bit, like shift register of device
+        if (!bits)
+            outgoing = next_byte();
+        const bit response = outgoing >> (7 - bits) & 1;
+        shifted = shifted << 1 | data;
+        if (++bits < 8)
+            return response;
+
+        transfer(std::span<const byte>(&shifted, 1), {});
+        shifted = 0;
+        bits = 0;
+        return response;
+    }
+
+    template <typename Traits>
+    byte BasicMockSpi<Traits>::transferByte(const_type<byte> data) noexcept {
+        byte response = 0;
+        transfer(std::span<const byte>(&data, 1), std::span<byte>(&response, 1));
+        return response;
+    }
+
+    template <typename Traits>
+    TransferStatus BasicMockSpi<Traits>::transfer(std::span<const byte> tx, std::span<byte> rx) noexcept {
+        if (SS == HIGH)
+            return TRANSFER_INVALID_STATE;
+
+        // Like shift register: byte i is received while byte i is sent
+        const array_size length = tx.size() > rx.size() ? tx.size() : rx.size();
+        for (array_size i = 0; i < length; ++i) {
+            if (command == EEPROM_25xx::CMD_READ && position >= INSTRUCTION_SIZE && frameStatus == TRANSFER_OK) {
+                const array_size rest = length - i;
+                handle_read_command(rx.size() > i ? rx.subspan(i, rx.size() - i < rest ? rx.size() - i : rest) : std::span<byte>());
+                position += rest;
+                payload += rest;
+                break;
+            }
+
+            const byte response = handle_byte(i < tx.size() ? tx[i] : 0);
+            if (i < rx.size())
+                rx[i] = response;
+        }
+
+        return frameStatus;
+    }
+
+    template <typename Traits>
+    byte BasicMockSpi<Traits>::handle_byte(const_type<byte> data) noexcept {
+        const array_size index = position++;
+        if (frameStatus != TRANSFER_OK)
+            return 0;
+
+        // 1st byte: instruction byte with command code
+        if (!index) {
+            instruction[0] = data;
+            command = Traits::decodeCommand(instruction);
+            if (command != EEPROM_25xx::CMD_RDSR && isBusy()) {
+                frameStatus = TRANSFER_DEVICE_BUSY;
+                return 0;
+            }
+            switch (command) {
+                case EEPROM_25xx::CMD_READ:
+                case EEPROM_25xx::CMD_WRITE:
+                case EEPROM_25xx::CMD_WREN:
+                case EEPROM_25xx::CMD_WRDI:
+                case EEPROM_25xx::CMD_RDSR:
+                case EEPROM_25xx::CMD_WRSR:
+                    return 0;
+                default:
+                    frameStatus = TRANSFER_INVALID_INSTRUCTION;
+                    return 0;
+            }
+        }
+
+        // STATUS register is clocked out continuously
+        if (command == EEPROM_25xx::CMD_RDSR) {
+            ++payload;
+            return next_byte();
+        }
+        // The first byte after CMD_WRSR is new STATUS register value, the rest are ignored
+        if (command == EEPROM_25xx::CMD_WRSR) {
+            if (index == 1) {
+                latch[0] = data;
+                latched = true;
+                ++payload;
+            }
+            return 0;
+        }
+        if (command != EEPROM_25xx::CMD_READ && command != EEPROM_25xx::CMD_WRITE)
+            return 0;
+
+        // The rest of instruction: address bytes
+        if (index < INSTRUCTION_SIZE) {
+            instruction[index] = data;
+            if (index == INSTRUCTION_SIZE - 1)
+                address = Traits::decodeAddress(instruction);
+            return 0;
+        }
+
+        // Data bytes of write are latched into page buffer wrapping inside page
+        if (!latched) {
+            std::memcpy(latch, memory.data() + address - address % Traits::PAGE_SIZE, Traits::PAGE_SIZE);
+            latched = true;
+        }
+        latch[(address + index - INSTRUCTION_SIZE) % Traits::PAGE_SIZE] = data;
+        ++payload;
+        return 0;
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::handle_read_command(std::span<byte> response) noexcept {
+        memory.read((address + position - INSTRUCTION_SIZE) % Traits::CAPACITY, response);
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::handle_frame_end() noexcept {
+        if (frameStatus != TRANSFER_OK)
+            return;
+
+        switch (command) {
+            case EEPROM_25xx::CMD_WREN:
+                writeEnabled = true;
+                return;
+            case EEPROM_25xx::CMD_WRDI:
+                writeEnabled = false;
+                return;
+            case EEPROM_25xx::CMD_WRSR:
+                if (!writeEnabled || !latched)
+                    return;
+
+                protection = latch[0] & (EEPROM_25xx::SR_BP0 | EEPROM_25xx::SR_BP1);
+                writeEnabled = false;
+                busyUntil = std::chrono::steady_clock::now() + writeCycleTime;
+                ++writeCycles;
+                return;
+            case EEPROM_25xx::CMD_WRITE:
+                // Page of protected block is ignored, so write enable latch stays set
+                if (!writeEnabled || !latched || address >= protected_from())
+                    return;
+
+                std::memcpy(memory.data() + address - address % Traits::PAGE_SIZE, latch, Traits::PAGE_SIZE);
+                writeEnabled = false;
+                busyUntil = std::chrono::steady_clock::now() + writeCycleTime;
+                ++writeCycles;
+                return;
+            default:
+                return;
+        }
+    }
+
+    template <typename Traits>
+    dword BasicMockSpi<Traits>::protected_from() const noexcept {
+        // BP1:BP0 = 01 protects upper quarter, 10 upper half, 11 whole array
+        switch (protection >> 2) {
+            case 1:
+                return Traits::CAPACITY - Traits::CAPACITY / 4;
+            case 2:
+                return Traits::CAPACITY / 2;
+            case 3:
+                return 0;
+            default:
+                return Traits::CAPACITY;
+        }
+    }
+
+    template <typename Traits>
+    byte BasicMockSpi<Traits>::next_byte() const noexcept {
+        // Instruction byte sets command, so only bytes after it may carry data
+        if (SS == HIGH || !position || frameStatus != TRANSFER_OK)
+            return 0;
+
+        if (command == EEPROM_25xx::CMD_RDSR)
+            return (isBusy() ? EEPROM_25xx::SR_WIP : 0) | (writeEnabled ? EEPROM_25xx::SR_WEL : 0) | protection;
+        if (command == EEPROM_25xx::CMD_READ && position >= INSTRUCTION_SIZE)
+            return memory.data()[(address + position - INSTRUCTION_SIZE) % Traits::CAPACITY];
+        return 0;
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::setByteArrayByAddress(const_type<pointer_size> address, byte_array data, const_type<array_size> length) {
+        if (!data || length < 1)
+            return;
+        memory.write(address, std::span<const byte>(data, length));
+    }
+
+    template <typename Traits>
+    const byte_array BasicMockSpi<Traits>::getByteArrayByAddress(const_type<pointer_size> address) const {
+        if (address > Traits::MAX_ADDRESS)
+            return nullptr;
+
+        return (byte_array)(memory.data() + address);
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::setWriteCycleTime(const_type<std::chrono::microseconds> time) noexcept {
+        writeCycleTime = time;
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::setBusFrequency(const_type<dword> frequency) noexcept {
+        clockTime = std::chrono::nanoseconds{(1000000000 + frequency / 2) / frequency};
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::setSimulatedWriteCycleTime(const_type<std::chrono::microseconds> time) noexcept {
+        simulatedWriteCycleTime = time;
+    }
+
+    template <typename Traits>
+    std::chrono::nanoseconds BasicMockSpi<Traits>::getElapsedTime() const noexcept {
+        // Device is occupied till the end of write cycle even if nothing follows it
+        return elapsed > simulatedBusyUntil ? elapsed : simulatedBusyUntil;
+    }
+
+    template <typename Traits>
+    const MockBusStats& BasicMockSpi<Traits>::getBusStats() const noexcept {
+        return total;
+    }
+
+    template <typename Traits>
+    const MockBusStats& BasicMockSpi<Traits>::getBusStats(const_type<byte> command) const noexcept {
+        return commands[command & 0x07];
+    }
+
+    template <typename Traits>
+    void BasicMockSpi<Traits>::resetBusStats() noexcept {
+        elapsed = simulatedBusyUntil = std::chrono::nanoseconds{0};
+        total = {};
+        for (MockBusStats& stats : commands)
+            stats = {};
+    }
+
+    template <typename Traits>
+    dword BasicMockSpi<Traits>::getWriteCycleCount() const noexcept {
+        return writeCycles;
+    }
+
+    template <typename Traits>
+    bool BasicMockSpi<Traits>::isBusy() const noexcept {
+        return std::chrono::steady_clock::now() < busyUntil;
+    }
+
+    /**
+    * @brief 25LC040A mock is instantiated once in mock_spi_driver.cpp.
+    */
+    extern template class BasicMockSpi<EEPROM_25LC040A_Traits>;
 #endif
 
 /**
 * @page Mock_Spi_page MockSpi interaction manual
 *
 * @section mock_spi_intro Introduction
-* This page contains information about data format of interacting with MockSpi. The only way to interact is using MockSpi::transferBytes. Other methods are @b not implemented and will raised NotImplementedException.
+* This page contains information about data format of interacting with BasicMockSpi (MockSpi is 25LC040A one). Frames are clocked by BasicMockSpi::transfer (or ISpiBitBang::transferBytes shim), BasicMockSpi::transferByte or BasicMockSpi::transferBit: every 8 bits of the last one form one byte of frame. Frames are delimited by BasicMockSpi::chipDeselect and BasicMockSpi::chipSelect.
 *
 * @section mock_spi_data_structures Data structures
-Request to EEPROM based 25LC040A microchip to <TT>read/write</TT> must contain information about address and command code (See @ref EEPROM_25LC040A::Command). Address and command code combination is instruction. Instruction consists of two bytes with following mask: <TT><b>0000xc</b></TT>. "x" is 9 bits address because 512 addresses are able to be accessed. "c" is command code that takes 3 bits.
-The request is an array of bytes where:
-1. 1st and 2nd bytes are instruction.
-2. 3rd and 4th bytes are bytes count to read/write. If EEPROM_25LC040A::Command::CMD_WREN is provided these bytes and following ones are ignored.
-3. 5th - nth bytes are bytes to write by given address. If EEPROM_25LC040A::Command::CMD_READ is provided these bytes and following ones are ignored.
+Frame is the byte stream clocked while <TT>SS</TT> is low, exactly as by datasheet. It starts with instruction that contains command code (See @ref EEPROM_25xx::Command) and, for <TT>read/write</TT>, address. Instruction is encoded by EEPROM_25xxTraits::encodeInstruction. For 25LC040A it consists of two bytes: <TT><b>0000A011</b></TT> command byte with address bit A8 in bit 3, followed by address bits A7-A0. Parts with 16 bits address use three bytes: command code followed by big-endian address.
+1. EEPROM_25xx::CMD_READ: instruction is followed by any count of read data bytes. Address is incremented after every byte and rolls over from <TT>Traits::MAX_ADDRESS</TT> to 0, so the whole device may be read by single frame.
+2. EEPROM_25xx::CMD_WRITE: instruction is followed by data bytes to write. Data is latched and written when <TT>SS</TT> goes high.
+3. EEPROM_25xx::CMD_WREN and EEPROM_25xx::CMD_WRDI: single command byte. They take effect when <TT>SS</TT> goes high.
+4. EEPROM_25xx::CMD_RDSR: command byte, STATUS register is received as 2nd byte of frame and repeated while frame goes on. EEPROM_25xx::SR_WIP, EEPROM_25xx::SR_WEL, EEPROM_25xx::SR_BP0 and EEPROM_25xx::SR_BP1 are emulated.
+5. EEPROM_25xx::CMD_WRSR: command byte followed by new STATUS register value. Only block protection bits are written when <TT>SS</TT> goes high.
+
+Response is clocked in the same frame: byte @c i is received while byte @c i is sent, so to read @c n bytes frame must be <TT>instruction + n</TT> bytes long. Frame may be split into any count of BasicMockSpi::transfer calls: bytes are parsed as they arrive.
+
+@section mock_spi_timing Write cycle
+Accepted EEPROM_25xx::CMD_WRITE starts internal write cycle which lasts BasicMockSpi::WRITE_CYCLE_TIME (see BasicMockSpi::setWriteCycleTime). While it is in progress EEPROM_25xx::SR_WIP is set and every instruction except EEPROM_25xx::CMD_RDSR is rejected. Write enable latch is reset when write is accepted, so every write must be preceded by EEPROM_25xx::CMD_WREN.
+Written data wraps inside page of <TT>Traits::PAGE_SIZE</TT> bytes. Frame without data bytes or not preceded by EEPROM_25xx::CMD_WREN doesn't start write cycle.
+Accepted EEPROM_25xx::CMD_WRSR starts write cycle too. EEPROM_25xx::CMD_WRITE into block protected by EEPROM_25xx::SR_BP0 and EEPROM_25xx::SR_BP1 (upper quarter, upper half or whole array) is ignored.
+
+@section mock_spi_cost Cost model
+Every frame is accounted on virtual clock (see BasicMockSpi::getElapsedTime) against SCK frequency (see BasicMockSpi::setBusFrequency): frame costs BasicMockSpi::CS_TIME and 8 SCK clocks per clocked byte, so instruction overhead is accounted like data. Accepted EEPROM_25xx::CMD_WRITE makes device busy for simulated write cycle time (see BasicMockSpi::setSimulatedWriteCycleTime) on virtual clock: STATUS register polling overlaps it, any other frame can't start earlier than its end, and elapsed time covers the last write cycle.
+Virtual clock never goes backwards and doesn't depend on emulated real time write cycle (see BasicMockSpi::setWriteCycleTime), so tests may complete write cycles instantly and still measure device time. Statistics are collected in total and by command code (see BasicMockSpi::getBusStats), so bytes per simulated second is <TT>payload / elapsed time</TT> for any driver API.
 
-To <TT>enable/disable</TT> writing the following instruction mask must be supplied: <TT><b>0000xc</b></TT>. "x" is any combination of 9 bits. "c" is command code that takes 3 bits.
+@section mock_spi_storage Storage
+Memory is MockStorage: anonymous zeroed mapping by default or image file mapped by BasicMockSpi::BasicMockSpi(const char*). Image is mapped without copying, so device state is loaded instantly and kept between runs.
 
 @section mock_spi_notes Notes
-The @b only command codes that can be provided are EEPROM_25LC040A::Command::CMD_READ, EEPROM_25LC040A::Command::CMD_WRITE, EEPROM_25LC040A::Command::CMD_WREN and EEPROM_25LC040A::Command::CMD_WRDI.
+The @b only command codes that can be provided are EEPROM_25xx::CMD_READ, EEPROM_25xx::CMD_WRITE, EEPROM_25xx::CMD_WREN, EEPROM_25xx::CMD_WRDI, EEPROM_25xx::CMD_RDSR and EEPROM_25xx::CMD_WRSR.
 */
@@ -0,0 +1,220 @@
+/**
+* @file mock_spi_pins.h
+* @brief Pin-level mock of 25xx EEPROM for bit-bang SPI backend.
+*/
+
+#ifndef MOCK_SPI_PINS_H
+
+    /**
+    * @def MOCK_SPI_PINS_H
+    * @brief Include module macros.
+    */
+    #define MOCK_SPI_PINS_H
+
+    #include "mock_spi_driver.h"
+    #include "spi_bit_bang.h"
+
+    /**
+    * @class BasicMockSpiPins
+    * @tparam Traits emulated device description. See EEPROM_25xxTraits.
+    * @brief GPIO pins wired to emulated 25xx EEPROM. Device samples edges like real one does: CS falling edge starts frame,
+    * MOSI is sampled on SCK rising edge, MISO is changed on SCK falling edge (SPI modes 0 and 3, MSB first).
+    * Every received byte is passed to byte-level BasicMockSpi, so memory, write cycles and bus statistics are the ones of the chip.
+    * Edges and pin writes are counted to measure cost of bit-bang backend.
+    */
+    template <typename Traits>
+    class BasicMockSpiPins final : public IGpioPins {
+    public:
+	/**
+	* @param chip byte-level mock of device.
+	* @brief Constructs pins. CS is high, SCK, MOSI and MISO are low.
+	*/
+        explicit BasicMockSpiPins(BasicMockSpi<Traits>* chip) noexcept;
+
+	/**
+	* @param level level of SCK.
+	* @brief Rising edge samples MOSI, falling edge shifts out the next bit to MISO.
+	*/
+        void writeSck(const_type<bit> level) noexcept override;
+
+	/**
+	* @param level level of MOSI.
+	* @brief Sets MOSI level.
+	*/
+        void writeMosi(const_type<bit> level) noexcept override;
+
+	/**
+	* @param level level of CS.
+	* @brief Falling edge starts frame, rising edge ends it. Incomplete byte is dropped.
+	*/
+        void writeCs(const_type<bit> level) noexcept override;
+
+	/**
+	* @returns MISO level.
+	*/
+        bit readMiso() noexcept override;
+
+	/**
+	* @brief Debugging method to get count of level changes of SCK, MOSI and CS.
+	*/
+        dword getEdgeCount() const noexcept;
+
+	/**
+	* @brief Debugging method to get count of pin writes including ones which don't change level.
+	*/
+        dword getWriteCount() const noexcept;
+
+	/**
+	* @brief Debugging method to reset edge and pin write counters.
+	*/
+        void resetPinStats() noexcept;
+
+    private:
+	/**
+	* @brief Byte-level mock of device.
+	*/
+        BasicMockSpi<Traits>* chip;
+
+	/**
+	* @brief SCK level.
+	*/
+        bit sck{false};
+
+	/**
+	* @brief MOSI level.
+	*/
+        bit mosi{false};
+
+	/**
+	* @brief CS level.
+	*/
+        bit cs{true};
+
+	/**
+	* @brief MISO level.
+	*/
+        bit miso{false};
+
+	/**
+	* @brief Bits received of current byte.
+	*/
+        byte received{0};
+
+	/**
+	* @brief Count of bits received of current byte.
+	*/
+        byte bits{0};
+
+	/**
+	* @brief Byte which is shifted out while current byte is received.
+	*/
+        byte response{0};
+
+	/**
+	* @brief Count of level changes.
+	*/
+        dword edges{0};
+
+	/**
+	* @brief Count of pin writes.
+	*/
+        dword writes{0};
+
+	/**
+	* @brief Auxiliary method to drive MISO by the next bit of response.
+	*/
+        void shift_out() noexcept;
+    };
+
+    /**
+    * @typedef MockSpiPins
+    * @brief Pin-level mock of 25LC040A microchip.
+    */
+    using MockSpiPins = BasicMockSpiPins<EEPROM_25LC040A_Traits>;
+
+    template <typename Traits>
+    BasicMockSpiPins<Traits>::BasicMockSpiPins(BasicMockSpi<Traits>* chip) noexcept : chip(chip) {}
+
+    template <typename Traits>
+    void BasicMockSpiPins<Traits>::writeSck(const_type<bit> level) noexcept {
+        ++writes;
+        if (level == sck)
+            return;
+        ++edges;
+        sck = level;
+        if (cs)
+            return;
+
+        if (!level) {
+            shift_out();
+            return;
+        }
+
+        // Complete byte is passed to chip, response of the next one is ready before its first falling edge
+        received = received << 1 | mosi;
+        if (++bits < 8)
+            return;
+        chip->transfer(std::span<const byte>(&received, 1), {});
+        response = chip->next_byte();
+        received = 0;
+        bits = 0;
+    }
+
+    template <typename Traits>
+    void BasicMockSpiPins<Traits>::writeMosi(const_type<bit> level) noexcept {
+        ++writes;
+        if (level == mosi)
+            return;
+        ++edges;
+        mosi = level;
+    }
+
+    template <typename Traits>
+    void BasicMockSpiPins<Traits>::writeCs(const_type<bit> level) noexcept {
+        ++writes;
+        if (level == cs)
+            return;
+        ++edges;
+        cs = level;
+
+        if (level) {
+            chip->chipSelect();
+            return;
+        }
+        chip->chipDeselect();
+        received = 0;
+        bits = 0;
+        response = chip->next_byte();
+        shift_out();
+    }
+
+    template <typename Traits>
+    bit BasicMockSpiPins<Traits>::readMiso() noexcept {
+        return miso;
+    }
+
+    template <typename Traits>
+    dword BasicMockSpiPins<Traits>::getEdgeCount() const noexcept {
+        return edges;
+    }
+
+    template <typename Traits>
+    dword BasicMockSpiPins<Traits>::getWriteCount() const noexcept {
+        return writes;
+    }
+
+    template <typename Traits>
+    void BasicMockSpiPins<Traits>::resetPinStats() noexcept {
+        edges = writes = 0;
+    }
+
+    template <typename Traits>
+    void BasicMockSpiPins<Traits>::shift_out() noexcept {
+        miso = response & 0x80 >> bits;
+    }
+
+    /**
+    * @brief 25LC040A pin-level mock is instantiated once in mock_spi_pins.cpp.
+    */
+    extern template class BasicMockSpiPins<EEPROM_25LC040A_Traits>;
+#endif
@@ -0,0 +1,105 @@
+/**
+* @file mock_storage.h
+* @brief Memory storage of mock devices.
+*/
+
+#ifndef MOCK_STORAGE_H
+
+    /**
+    * @def MOCK_STORAGE_H
+    * @brief Include module macros.
+    */
+    #define MOCK_STORAGE_H
+
+    #include "spi_interface.h"
+
+    #include <span>
+
+    /**
+    * @class MockStorage
+    * @brief Memory mapped storage of mock devices. Memory is either anonymous (state is lost with object) or image file (state is kept between runs).
+    * Mapping is lazy: pages of image are loaded by operating system on first access, so large images are opened instantly and nothing is copied at startup.
+    * Ranges wrap at the end of storage like device address does.
+    */
+    class MockStorage {
+    public:
+	/**
+	* @param size storage size in bytes.
+	* @param fill value of every byte of new storage: 0x00 for EEPROM, 0xFF for erased flash.
+	* @throw std::invalid_argument if @c size is null.
+	* @throw std::bad_alloc if memory is not mapped.
+	* @brief Constructs anonymous storage.
+	*/
+        explicit MockStorage(const_type<dword> size, const_type<byte> fill = 0x00);
+
+	/**
+	* @param path path to image file. File is created if it doesn't exist.
+	* @param size storage size in bytes.
+	* @param fill value of bytes the image is extended with when file is shorter than @c size.
+	* @throw std::invalid_argument if @c size is null or @c path is nullptr.
+	* @throw std::runtime_error if file is not opened or mapped.
+	* @brief Constructs storage backed by image file. Changes are written to file by operating system, see MockStorage::sync.
+	*/
+        MockStorage(const char* path, const_type<dword> size, const_type<byte> fill = 0x00);
+
+        MockStorage(const MockStorage&) = delete;
+        MockStorage& operator=(const MockStorage&) = delete;
+
+	/**
+	* @brief Unmaps memory and closes image file.
+	*/
+        ~MockStorage();
+
+	/**
+	* @return storage size in bytes.
+	*/
+        dword size() const noexcept;
+
+	/**
+	* @return pointer to the first byte of storage.
+	*/
+        byte* data() noexcept;
+
+	/**
+	* @return pointer to the first byte of storage.
+	*/
+        const byte* data() const noexcept;
+
+	/**
+	* @param address address to read from.
+	* @param buffer buffer to fill.
+	* @brief Copy range into buffer. At most two memcpy: range is split only at the end of storage.
+	*/
+        void read(const_type<dword> address, std::span<byte> buffer) const noexcept;
+
+	/**
+	* @param address address to write to.
+	* @param data bytes to write.
+	* @brief Copy bytes into range. At most two memcpy: range is split only at the end of storage.
+	*/
+        void write(const_type<dword> address, std::span<const byte> data) noexcept;
+
+	/**
+	* @throw std::runtime_error if image is not written.
+	* @brief Write changed pages of image file synchronously. Does nothing for anonymous storage.
+	*/
+        void sync() const;
+
+    private:
+	/**
+	* @brief Mapped memory.
+	*/
+        byte* memory{nullptr};
+
+	/**
+	* @brief Storage size in bytes.
+	*/
+        dword length;
+
+	/**
+	* @brief Image file descriptor, -1 for anonymous storage.
+	*/
+        int file{-1};
+    };
+
+#endif
@@ -0,0 +1,278 @@
+/**
+* @file nor_flash.h
+* @brief Provides driver for SPI NOR flash.
+*/
+
+#ifndef NOR_FLASH_H
+
+    /**
+    * @def NOR_FLASH_H
+    * @brief Include module macro.
+    */
+    #define NOR_FLASH_H
+
+    #include "spi_interface.h"
+
+    #include <chrono>
+    #include <span>
+
+    /**
+    * @typedef flash_address
+    * @brief 24 bits address of SPI NOR flash.
+    */
+    using flash_address = dword;
+
+    /**
+    * @class NorFlash
+    * @brief Driver class for SPI NOR flash with 24 bits address (JEDEC command set). Provides high level interface to read, program and erase flash.
+    * Every instruction is a single frame between CS low and CS high. Command code is the first byte, address follows it in big-endian order.
+    */
+    class NorFlash {
+    public:
+	/**
+	* @enum Command
+	* @brief Set of used commands of SPI NOR flash.
+	*/
+        enum Command : byte {
+            CMD_READ = 0x03, ///< Read, no dummy byte.
+            CMD_FAST_READ = 0x0B, ///< Fast read, one dummy byte after address.
+            CMD_PAGE_PROGRAM = 0x02, ///< Program up to one page.
+            CMD_WREN = 0x06, ///< Enable writing.
+            CMD_WRDI = 0x04, ///< Disable writing.
+            CMD_RDSR = 0x05, ///< Read STATUS register.
+            CMD_SECTOR_ERASE = 0x20, ///< Erase 4 KiB sector.
+            CMD_BLOCK_ERASE = 0xD8, ///< Erase 64 KiB block.
+            CMD_CHIP_ERASE = 0xC7 ///< Erase whole chip.
+        };
+
+	/**
+	* @enum StatusBit
+	* @brief Bits of STATUS register of SPI NOR flash.
+	*/
+        enum StatusBit : byte {
+            SR_WIP = 0b0001, ///< Write-In-Process: program or erase is in progress.
+            SR_WEL = 0b0010 ///< Write Enable Latch.
+        };
+
+	/**
+	* @brief Size of program page in bytes. Single CMD_PAGE_PROGRAM instruction can't cross page boundary.
+	*/
+        static constexpr array_size PAGE_SIZE = 256;
+
+	/**
+	* @brief Size of the smallest erase unit (sector) in bytes.
+	*/
+        static constexpr array_size SECTOR_SIZE = 4096;
+
+	/**
+	* @brief Size of the largest erase unit (block) in bytes.
+	*/
+        static constexpr array_size BLOCK_SIZE = 65536;
+
+	/**
+	* @brief Maximum capacity addressed by 24 bits address.
+	*/
+        static constexpr dword MAX_CAPACITY = dword{1} << 24;
+
+	/**
+	* @brief Typical page program time (tPP) by datasheet. Seeds STATUS register polling.
+	*/
+        static constexpr std::chrono::microseconds PAGE_PROGRAM_TIME{700};
+
+	/**
+	* @brief Typical sector erase time (tSE) by datasheet. Seeds STATUS register polling.
+	*/
+        static constexpr std::chrono::microseconds SECTOR_ERASE_TIME{45000};
+
+	/**
+	* @brief Typical block erase time (tBE) by datasheet. Seeds STATUS register polling, chip erase is expected to last it for every block.
+	*/
+        static constexpr std::chrono::microseconds BLOCK_ERASE_TIME{150000};
+
+	/**
+	* @brief Maximum time to wait for page program completion. Ten times of datasheet maximum tPP.
+	*/
+        static constexpr std::chrono::microseconds PAGE_PROGRAM_TIMEOUT{30000};
+
+	/**
+	* @brief Maximum time to wait for sector erase completion. Ten times of datasheet maximum tSE.
+	*/
+        static constexpr std::chrono::microseconds SECTOR_ERASE_TIMEOUT{4000000};
+
+	/**
+	* @brief Maximum time to wait for block erase completion. Ten times of datasheet maximum tBE.
+	*/
+        static constexpr std::chrono::microseconds BLOCK_ERASE_TIMEOUT{20000000};
+
+	/**
+	* @brief Maximum time to wait for chip erase completion. Ten times of datasheet maximum tCE.
+	*/
+        static constexpr std::chrono::microseconds CHIP_ERASE_TIMEOUT{2000000000};
+
+	/**
+	* @brief Count of STATUS register polls made right away before waiting for operation starts to sleep.
+	*/
+        static constexpr byte QUICK_POLLS = 2;
+
+	/**
+	* @brief The shortest interval between STATUS register polls while waiting for operation.
+	*/
+        static constexpr std::chrono::microseconds POLL_INTERVAL_MIN{10};
+
+	/**
+	* @param spi SPI protocol compatible driver for device.
+	* @param capacity device size in bytes. Multiple of NorFlash::BLOCK_SIZE, no more than NorFlash::MAX_CAPACITY.
+	* @throw std::invalid_argument if @c capacity is invalid.
+	* @brief Constructs NOR flash driver with SPI compatible driver.
+	*/
+        NorFlash(ISpiBitBang* spi, const_type<dword> capacity);
+
+	/**
+	* @return device size in bytes.
+	*/
+        dword capacity() const noexcept;
+
+	/**
+	* @brief Read byte value by address.
+        * @param address address to read byte from.
+        * @throw See NorFlash::readInto.
+        * @return read byte value.
+        */
+        byte readByte(const_type<flash_address> address) const;
+
+	/**
+	* @brief Read byte array of any length by address into caller provided buffer by single CMD_FAST_READ instruction. No memory is allocated.
+        * @param address address to read byte array from.
+	* @param buffer buffer to fill. Its size is bytes count to read.
+        * @throw
+	* - std::runtime_error if spi == nullptr.
+	* - std::invalid_argument if buffer is empty.
+	* - std::out_of_range @c address is not less than NorFlash::capacity.
+	* - std::exception See validateTransferStatus for information.
+	* @note Data is streamed: CS is held low while data is clocked into @c buffer chunk by chunk. Reading wraps at the end of device like real flash does.
+        */
+        void readInto(const_type<flash_address> address, std::span<byte> buffer) const;
+
+	/**
+	* @brief Program byte array by address. Data is split into page aligned CMD_PAGE_PROGRAM bursts, each one is followed by busy polling.
+        * @param address address to program byte array to.
+	* @param data bytes to program.
+        * @throw
+	* - std::runtime_error if spi == nullptr.
+	* - std::invalid_argument if data is empty.
+	* - std::out_of_range range exceeds NorFlash::capacity.
+	* - std::runtime_error program is not completed in NorFlash::PAGE_PROGRAM_TIMEOUT.
+	* - std::exception See validateTransferStatus for information.
+	* @note Programming only clears bits. Range must be erased before (see NorFlash::erase) to get exactly @c data.
+	* @return count of page bursts.
+        */
+        dword program(const_type<flash_address> address, std::span<const byte> data) const;
+
+	/**
+	* @brief Erase range. Every step uses the largest erase unit which is aligned and fits the rest of range: whole chip, 64 KiB block or 4 KiB sector.
+        * @param address address of range start. Multiple of NorFlash::SECTOR_SIZE.
+	* @param length count of bytes to erase. Multiple of NorFlash::SECTOR_SIZE.
+        * @throw
+	* - std::runtime_error if spi == nullptr.
+	* - std::invalid_argument if @c length is null or range is not sector aligned.
+	* - std::out_of_range range exceeds NorFlash::capacity.
+	* - std::runtime_error erase is not completed in time (see NorFlash::SECTOR_ERASE_TIMEOUT and others).
+	* - std::exception See validateTransferStatus for information.
+	* @return count of erase instructions.
+        */
+        dword erase(const_type<flash_address> address, const_type<dword> length) const;
+
+	/**
+	* @brief Erase whole chip by CMD_CHIP_ERASE.
+        * @throw See NorFlash::erase.
+        */
+        void eraseChip() const;
+
+	/**
+	* @throw std::exception See validateTransferStatus for information.
+	* @return STATUS register value. See NorFlash::StatusBit.
+	* @brief Read STATUS register.
+	*/
+        byte readStatus() const;
+
+	/**
+	* @throw std::exception See validateTransferStatus for information.
+	* @return whether program or erase is in progress.
+	*/
+        bool isBusy() const;
+
+    private:
+	/**
+	* @brief Size of stack buffer used to stream reads. Reads of any length use the same buffer.
+	*/
+        static constexpr array_size STREAM_CHUNK_SIZE = 256;
+
+	/**
+	* @brief Count of bytes of command code and address.
+	*/
+        static constexpr byte HEADER_SIZE = 4;
+
+	/**
+	* @brief SPI protocol compatible driver.
+	*/
+        ISpiBitBang* spi;
+
+	/**
+	* @brief Device size in bytes.
+	*/
+        dword size;
+
+	/**
+	* @throw std::runtime_error if spi == nullptr.
+	* @brief Validate SPI driver.
+	*/
+        inline void validateSpi() const;
+
+	/**
+	* @param address address of range start.
+	* @param length count of bytes in range.
+	* @throw std::out_of_range range exceeds NorFlash::capacity.
+	* @brief Validate range.
+	*/
+        inline void validateRange(const_type<flash_address> address, const_type<dword> length) const;
+
+	/**
+	* @param frame buffer for NorFlash::HEADER_SIZE bytes.
+	* @param cmd command to execute. See NorFlash::Command.
+	* @param address address to execute command to.
+	* @brief Encode command code and big-endian address.
+	*/
+        static inline void createHeader(byte* frame, const_type<Command> cmd, const_type<flash_address> address) noexcept;
+
+	/**
+	* @param cmd instruction to execute with writing enabled.
+	* @param address address to execute command to.
+	* @param data bytes to send after address.
+	* @param expected typical time of operation.
+	* @param timeout maximum time of operation.
+	* @throw std::exception See validateTransferStatus for information.
+	* @throw std::runtime_error operation is not completed in @c timeout.
+	* @brief Enable writing, execute instruction and poll STATUS register until NorFlash::SR_WIP bit is cleared.
+	*/
+        void execute(const_type<Command> cmd, const_type<flash_address> address, std::span<const byte> data, const_type<std::chrono::microseconds> expected,
+                     const_type<std::chrono::microseconds> timeout) const;
+
+	/**
+	* @param expected typical time of operation.
+	* @param timeout maximum time to wait.
+	* @throw std::runtime_error operation is not completed in @c timeout.
+	* @brief Poll STATUS register until NorFlash::SR_WIP bit is cleared. NorFlash::QUICK_POLLS polls right away catch short operations,
+	* then driver sleeps till half of @c expected and polls with doubling interval from 1/16 to 1/4 of it, so erases don't flood bus nor keep core busy.
+	*/
+        void waitReady(const_type<std::chrono::microseconds> expected, const_type<std::chrono::microseconds> timeout) const;
+
+	/**
+	* @param tx bytes to send.
+	* @param rx buffer for received bytes.
+	* @throw std::exception See validateTransferStatus for information.
+	* @brief Execute single full-duplex transaction by ISpiBitBang::transact: set CS low, transfer, set CS high.
+	*/
+        void transact(std::span<const byte> tx, std::span<byte> rx) const;
+    };
+
+#endif
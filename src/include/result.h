@@ -0,0 +1,200 @@
+/**
+* @file result.h
+* @brief Provides error codes and result type of exception-free API.
+*/
+
+#ifndef RESULT_H
+
+    /**
+    * @def RESULT_H
+    * @brief Include module macro.
+    */
+    #define RESULT_H
+
+    #include "spi_interface.h"
+
+    #include <type_traits>
+
+    /**
+    * @enum ErrorCode
+    * @brief Errors of exception-free API. Every error of throwing API has its code, see ::throwError.
+    */
+    enum ErrorCode : byte {
+        ERROR_NONE = 0, ///< No error.
+        ERROR_INVALID_ARGUMENT, ///< Given argument is not valid. Thrown as std::invalid_argument.
+        ERROR_OUT_OF_RANGE, ///< Given address or index is out of device. Thrown as std::out_of_range.
+        ERROR_NO_BACKEND, ///< SPI backend is nullptr. Thrown as std::runtime_error.
+        ERROR_STOPPED, ///< Device is stopped. Thrown as std::runtime_error.
+        ERROR_TIMEOUT, ///< Write cycle is not completed in time. Thrown as std::runtime_error.
+        ERROR_NO_MEMORY, ///< Not enough memory. Thrown as std::bad_alloc.
+        ERROR_INVALID_STATE, ///< Bus is not in state to transfer data. See TransferStatus::TRANSFER_INVALID_STATE.
+        ERROR_DEVICE_BUSY, ///< Device rejects request. See TransferStatus::TRANSFER_DEVICE_BUSY.
+        ERROR_INVALID_INSTRUCTION ///< Device does not support instruction. See TransferStatus::TRANSFER_INVALID_INSTRUCTION.
+    };
+
+    /**
+    * @param status transfer status.
+    * @return error code of @c status, ErrorCode::ERROR_NONE for TransferStatus::TRANSFER_OK.
+    */
+    constexpr ErrorCode toErrorCode(const_type<TransferStatus> status) noexcept {
+        switch (status) {
+            case TRANSFER_OK:
+                return ERROR_NONE;
+            case TRANSFER_INVALID_ARGUMENT:
+                return ERROR_INVALID_ARGUMENT;
+            case TRANSFER_INVALID_STATE:
+                return ERROR_INVALID_STATE;
+            case TRANSFER_DEVICE_BUSY:
+                return ERROR_DEVICE_BUSY;
+            case TRANSFER_INVALID_INSTRUCTION:
+                return ERROR_INVALID_INSTRUCTION;
+            case TRANSFER_NO_MEMORY:
+                return ERROR_NO_MEMORY;
+            default:
+                return ERROR_INVALID_STATE;
+        }
+    }
+
+    /**
+    * @param error error code.
+    * @return human readable description of @c error.
+    */
+    const char* describeError(const_type<ErrorCode> error) noexcept;
+
+    /**
+    * @param error error code, not ErrorCode::ERROR_NONE.
+    * @param where name of failed method, it prefixes message.
+    * @throw
+    * - std::invalid_argument if @c error is ErrorCode::ERROR_INVALID_ARGUMENT.
+    * - std::out_of_range if @c error is ErrorCode::ERROR_OUT_OF_RANGE.
+    * - std::bad_alloc if @c error is ErrorCode::ERROR_NO_MEMORY.
+    * - std::runtime_error if @c error is any other error.
+    * @note Without exception support (<TT>-fno-exceptions</TT>) aborts instead. Defined out of line, so callers of throwing API don't inline unwinding code.
+    * @brief Converts error code of exception-free API into exception of throwing API.
+    */
+    [[noreturn]] void throwError(const_type<ErrorCode> error, const char* where);
+
+    /**
+    * @class Result
+    * @tparam T type of value. Must be trivially copyable: result is returned in registers like plain value.
+    * @brief Value or error code returned by exception-free API, like @c std::expected. Implicitly constructed from value on success and from ErrorCode on failure.
+    */
+    template <typename T>
+    class [[nodiscard]] Result {
+        static_assert(std::is_trivially_copyable_v<T>, "Result value must be trivially copyable");
+
+    public:
+	/**
+	* @param value value of successful call.
+	* @brief Constructs success.
+	*/
+        constexpr Result(const T& value) noexcept : stored(value), code(ERROR_NONE) {}
+
+	/**
+	* @param error error code of failed call, not ErrorCode::ERROR_NONE.
+	* @brief Constructs failure.
+	*/
+        constexpr Result(const ErrorCode error) noexcept : empty(), code(error) {}
+
+	/**
+	* @return whether call succeeded.
+	*/
+        constexpr bool ok() const noexcept {
+            return code == ERROR_NONE;
+        }
+
+	/**
+	* @return whether call succeeded.
+	*/
+        constexpr explicit operator bool() const noexcept {
+            return ok();
+        }
+
+	/**
+	* @return error code, ErrorCode::ERROR_NONE on success.
+	*/
+        constexpr ErrorCode error() const noexcept {
+            return code;
+        }
+
+	/**
+	* @warning Must be called on success only.
+	* @return value of successful call.
+	*/
+        constexpr const T& value() const noexcept {
+            return stored;
+        }
+
+	/**
+	* @param fallback value returned on failure.
+	* @return value of successful call or @c fallback.
+	*/
+        constexpr T valueOr(const T& fallback) const noexcept {
+            return ok() ? stored : fallback;
+        }
+
+    private:
+        union {
+	    /**
+	    * @brief Placeholder of failure: @c T may be not default constructible.
+	    */
+            char empty;
+
+	    /**
+	    * @brief Value of successful call.
+	    */
+            T stored;
+        };
+
+	/**
+	* @brief Error code.
+	*/
+        ErrorCode code;
+    };
+
+    /**
+    * @class Result<void>
+    * @brief Result of exception-free call without value: error code only.
+    */
+    template <>
+    class [[nodiscard]] Result<void> {
+    public:
+	/**
+	* @brief Constructs success.
+	*/
+        constexpr Result() noexcept : code(ERROR_NONE) {}
+
+	/**
+	* @param error error code, ErrorCode::ERROR_NONE is success.
+	* @brief Constructs result from error code.
+	*/
+        constexpr Result(const ErrorCode error) noexcept : code(error) {}
+
+	/**
+	* @return whether call succeeded.
+	*/
+        constexpr bool ok() const noexcept {
+            return code == ERROR_NONE;
+        }
+
+	/**
+	* @return whether call succeeded.
+	*/
+        constexpr explicit operator bool() const noexcept {
+            return ok();
+        }
+
+	/**
+	* @return error code, ErrorCode::ERROR_NONE on success.
+	*/
+        constexpr ErrorCode error() const noexcept {
+            return code;
+        }
+
+    private:
+	/**
+	* @brief Error code.
+	*/
+        ErrorCode code;
+    };
+#endif
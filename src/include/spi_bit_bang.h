@@ -0,0 +1,283 @@
+/**
+* @file spi_bit_bang.h
+* @brief Provides SPI backend which bit-bangs GPIO pins.
+*/
+
+#ifndef SPI_BIT_BANG_H
+
+    /**
+    * @def SPI_BIT_BANG_H
+    * @brief Include module macro.
+    */
+    #define SPI_BIT_BANG_H
+
+    #include "spi_interface.h"
+
+    #include <array>
+    #include <concepts>
+    #include <utility>
+
+    /**
+    * @enum SpiMode
+    * @brief SPI modes: clock polarity (CPOL) is bit 1, clock phase (CPHA) is bit 0.
+    */
+    enum SpiMode : byte {
+        SPI_MODE_0 = 0b00, ///< SCK idles low, data is sampled on rising edge.
+        SPI_MODE_1 = 0b01, ///< SCK idles low, data is sampled on falling edge.
+        SPI_MODE_2 = 0b10, ///< SCK idles high, data is sampled on falling edge.
+        SPI_MODE_3 = 0b11 ///< SCK idles high, data is sampled on rising edge.
+    };
+
+    /**
+    * @enum BitOrder
+    * @brief Order of bits of byte on data lines.
+    */
+    enum BitOrder : byte {
+        MSB_FIRST = 0, ///< The most significant bit is sent first. 25xx devices use it.
+        LSB_FIRST = 1 ///< The least significant bit is sent first.
+    };
+
+    /**
+    * @class IGpioPins
+    * @brief Interface for GPIO pins of SPI master: SCK, MOSI and CS outputs and MISO input. @c true is high level.
+    */
+    class IGpioPins {
+    public:
+	/**
+	* @brief Virtual destructor.
+	*/
+        virtual ~IGpioPins() = default;
+
+	/**
+	* @param level level of SCK.
+	* @brief Drives clock line.
+	*/
+        virtual void writeSck(const_type<bit> level) noexcept = 0;
+
+	/**
+	* @param level level of MOSI.
+	* @brief Drives data line from master.
+	*/
+        virtual void writeMosi(const_type<bit> level) noexcept = 0;
+
+	/**
+	* @param level level of CS.
+	* @brief Drives chip select line. Device is selected by low level.
+	*/
+        virtual void writeCs(const_type<bit> level) noexcept = 0;
+
+	/**
+	* @returns level of MISO.
+	* @brief Samples data line from device.
+	*/
+        virtual bit readMiso() noexcept = 0;
+    };
+
+    /**
+    *   @concept GpioPins
+    *   @brief Requirements to GPIO pins used by BasicSpiBitBang. Every IGpioPins implementation satisfies it.
+    */
+    template <typename T>
+    concept GpioPins = requires(T& pins, const bit level) {
+        pins.writeSck(level);
+        pins.writeMosi(level);
+        pins.writeCs(level);
+        { pins.readMiso() } -> std::convertible_to<bit>;
+    };
+
+    /**
+    * @class BasicSpiBitBang
+    * @tparam Pins GPIO pins. See ::GpioPins.
+    * @tparam Mode SPI mode.
+    * @tparam Order bit order.
+    * @brief SPI backend which bit-bangs GPIO pins. Mode and bit order are bound at compile time: byte is shifted by unrolled sequence
+    * of 8 clocks with bit masks from constant table, so there is no loop counter and no mode branch in the inner loop.
+    * MOSI is written only when its level changes. When @c Pins is concrete (preferably @c final) class pin accesses are not virtual.
+    * @warning Level of MOSI is cached, so backend must be the only writer of pins.
+    */
+    template <GpioPins Pins, SpiMode Mode = SPI_MODE_0, BitOrder Order = MSB_FIRST>
+    class BasicSpiBitBang final : public ISpiBitBang {
+    public:
+	/**
+	* @param pins GPIO pins of bus.
+	* @brief Constructs backend and drives pins to idle levels: SCK by mode, MOSI low, CS high.
+	*/
+        explicit BasicSpiBitBang(Pins* pins) noexcept;
+
+	/**
+	* @brief Sets SS level to high.
+	*/
+        void chipSelect() override;
+
+	/**
+	* @brief Sets SS level to low.
+	*/
+        void chipDeselect() override;
+
+	/**
+	* @param data bit to send.
+	* @returns bit received on the same clock.
+	* @throw std::runtime_error if <TT>SS</TT>'s state is high (TransferStatus::TRANSFER_INVALID_STATE, see validateTransferStatus). Nothing is clocked.
+	* @brief Clocks single bit.
+	*/
+        bit transferBit(const_type<bit> data) override;
+
+	/**
+	* @param data byte to send.
+	* @returns byte received on the same 8 clocks.
+	* @throw std::runtime_error if <TT>SS</TT>'s state is high (TransferStatus::TRANSFER_INVALID_STATE, see validateTransferStatus). Nothing is clocked.
+	* @brief Clocks single byte in configured bit order.
+	*/
+        byte transferByte(const_type<byte> data) override;
+
+	/**
+	* @param tx bytes to send.
+	* @param rx buffer for received bytes.
+	* @returns
+	* - TransferStatus::TRANSFER_OK if bytes are clocked.
+	* - TransferStatus::TRANSFER_INVALID_STATE if <TT>SS</TT>'s state is high.
+	* @brief See ISpiBitBang::transfer.
+	*/
+        TransferStatus transfer(std::span<const byte> tx, std::span<byte> rx) noexcept override;
+
+    private:
+	/**
+	* @brief Idle level of SCK.
+	*/
+        static constexpr bit CPOL = Mode & 0b10;
+
+	/**
+	* @brief Whether data is sampled on trailing edge of clock.
+	*/
+        static constexpr bit CPHA = Mode & 0b01;
+
+	/**
+	* @brief Bit masks in order of sending.
+	*/
+        static constexpr std::array<byte, 8> MASKS = [] {
+            std::array<byte, 8> masks{};
+            for (byte i = 0; i < 8; ++i)
+                masks[i] = Order == MSB_FIRST ? 0x80 >> i : 1 << i;
+            return masks;
+        }();
+
+	/**
+	* @brief GPIO pins of bus.
+	*/
+        Pins* pins;
+
+	/**
+	* @brief Current level of MOSI.
+	*/
+        bit mosi{false};
+
+	/**
+	* @brief Whether device is selected.
+	*/
+        bit selected{false};
+
+	/**
+	* @param data bit to send.
+	* @returns bit received.
+	* @brief Auxiliary method to clock single bit: leading and trailing edges of SCK.
+	*/
+        bit clock(const_type<bit> data) noexcept;
+
+	/**
+	* @param data byte to send.
+	* @returns byte received.
+	* @brief Auxiliary method to clock single byte by unrolled sequence of clocks.
+	*/
+        byte shift(const_type<byte> data) noexcept;
+    };
+
+    /**
+    * @typedef SpiBitBang
+    * @brief Bit-bang backend over runtime polymorphic pins in SPI mode 0, MSB first, as 25xx devices expect.
+    */
+    using SpiBitBang = BasicSpiBitBang<IGpioPins>;
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    BasicSpiBitBang<Pins, Mode, Order>::BasicSpiBitBang(Pins* pins) noexcept : pins(pins) {
+        pins->writeCs(true);
+        pins->writeSck(CPOL);
+        pins->writeMosi(false);
+    }
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    void BasicSpiBitBang<Pins, Mode, Order>::chipSelect() {
+        pins->writeCs(true);
+        selected = false;
+    }
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    void BasicSpiBitBang<Pins, Mode, Order>::chipDeselect() {
+        pins->writeCs(false);
+        selected = true;
+    }
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    bit BasicSpiBitBang<Pins, Mode, Order>::transferBit(const_type<bit> data) {
+        if (!selected)
+            validateTransferStatus(TRANSFER_INVALID_STATE);
+
+        return clock(data);
+    }
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    byte BasicSpiBitBang<Pins, Mode, Order>::transferByte(const_type<byte> data) {
+        if (!selected)
+            validateTransferStatus(TRANSFER_INVALID_STATE);
+
+        return shift(data);
+    }
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    TransferStatus BasicSpiBitBang<Pins, Mode, Order>::transfer(std::span<const byte> tx, std::span<byte> rx) noexcept {
+        if (!selected)
+            return TRANSFER_INVALID_STATE;
+
+        const array_size length = tx.size() > rx.size() ? tx.size() : rx.size();
+        for (array_size i = 0; i < length; ++i) {
+            const byte response = shift(i < tx.size() ? tx[i] : 0);
+            if (i < rx.size())
+                rx[i] = response;
+        }
+
+        return TRANSFER_OK;
+    }
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    bit BasicSpiBitBang<Pins, Mode, Order>::clock(const_type<bit> data) noexcept {
+        // CPHA = 0: data is set before leading edge and sampled on it. CPHA = 1: data is set on leading edge and sampled on trailing one
+        if constexpr (CPHA)
+            pins->writeSck(!CPOL);
+        if (data != mosi) {
+            pins->writeMosi(data);
+            mosi = data;
+        }
+        if constexpr (!CPHA) {
+            pins->writeSck(!CPOL);
+            const bit sample = pins->readMiso();
+            pins->writeSck(CPOL);
+            return sample;
+        } else {
+            pins->writeSck(CPOL);
+            return pins->readMiso();
+        }
+    }
+
+    template <GpioPins Pins, SpiMode Mode, BitOrder Order>
+    byte BasicSpiBitBang<Pins, Mode, Order>::shift(const_type<byte> data) noexcept {
+        byte result = 0;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((result |= clock(data & MASKS[I]) ? MASKS[I] : 0), ...);
+        }(std::make_index_sequence<8>{});
+        return result;
+    }
+
+    /**
+    * @brief Runtime polymorphic backend is instantiated once in spi_bit_bang.cpp.
+    */
+    extern template class BasicSpiBitBang<IGpioPins>;
+#endif
@@ -0,0 +1,210 @@
+/**
+* @file spi_bus.h
+* @brief Provides arbiter of SPI bus shared by several chips with separate chip select lines.
+*/
+
+#ifndef SPI_BUS_H
+
+    /**
+    * @def SPI_BUS_H
+    * @brief Include module macro.
+    */
+    #define SPI_BUS_H
+
+    #include "spi_interface.h"
+
+    #include <atomic>
+
+    /**
+    * @class IChipSelect
+    * @brief Interface for chip select line of single chip on shared SPI bus.
+    */
+    class IChipSelect {
+    public:
+	/**
+	* @brief Virtual destructor.
+	*/
+        virtual ~IChipSelect() = default;
+
+	/**
+	* @brief Sets line active (@c SS low): chip listens to bus.
+	*/
+        virtual void activate() noexcept = 0;
+
+	/**
+	* @brief Sets line inactive (@c SS high): chip releases bus.
+	*/
+        virtual void deactivate() noexcept = 0;
+    };
+
+    /**
+    * @class SpiBus
+    * @brief Arbiter of SPI bus shared by several chips and threads. Owns physical backend (data lines) and serialises whole frames on it.
+    *
+    * Every chip is accessed through SpiBus::Device handle with its own chip select line. Bus is owned by a thread only while frame is on the wire,
+    * so write cycle polling of one chip doesn't block other chips.
+    * Single-transfer frames (SpiBus::Device::transact) are queued lock-free and executed by combining: the thread which gets the bus executes
+    * all queued frames of other threads back-to-back before releasing it.
+    */
+    class SpiBus {
+    public:
+	/**
+	* @class Device
+	* @brief Handle of single chip on shared bus. Works as ISpiBitBang for drivers, so any driver can be used on shared bus.
+	* @warning Handle is used by single thread at a time: frames of one chip can't interleave anyway. Threads share bus through their own handles.
+	*/
+        class Device final : public ISpiBitBang {
+        public:
+	    /**
+	    * @param bus arbiter of shared bus.
+	    * @param line chip select line of chip.
+	    * @brief Constructs handle of chip.
+	    */
+            Device(SpiBus& bus, IChipSelect* line) noexcept;
+
+	    /**
+	    * @brief Ends frame: sets chip select line inactive and releases bus. Frames queued by other threads are executed before release.
+	    */
+            void chipSelect() override;
+
+	    /**
+	    * @brief Starts frame: waits for bus and sets chip select line active. Use for frames of several transfers.
+	    */
+            void chipDeselect() override;
+
+	    /**
+	    * @param data bit to send.
+	    * @returns bit received by physical backend.
+	    * @throw std::runtime_error if frame is not started by SpiBus::Device::chipDeselect (TransferStatus::TRANSFER_INVALID_STATE, see validateTransferStatus).
+	    * @brief Clocks single bit inside frame started by SpiBus::Device::chipDeselect.
+	    */
+            bit transferBit(const_type<bit> data) override;
+
+	    /**
+	    * @param data byte to send.
+	    * @returns byte received by physical backend.
+	    * @throw std::runtime_error if frame is not started by SpiBus::Device::chipDeselect (TransferStatus::TRANSFER_INVALID_STATE, see validateTransferStatus).
+	    * @brief Clocks single byte inside frame started by SpiBus::Device::chipDeselect.
+	    */
+            byte transferByte(const_type<byte> data) override;
+
+	    /**
+	    * @param tx bytes to send.
+	    * @param rx buffer for response.
+	    * @returns TransferStatus::TRANSFER_INVALID_STATE if frame is not started by SpiBus::Device::chipDeselect, otherwise status of physical backend.
+	    * @brief Transfers bytes inside frame started by SpiBus::Device::chipDeselect.
+	    */
+            TransferStatus transfer(std::span<const byte> tx, std::span<byte> rx) noexcept override;
+
+	    /**
+	    * @param tx bytes to send.
+	    * @param rx buffer for response.
+	    * @returns TransferStatus::TRANSFER_INVALID_STATE if frame started by SpiBus::Device::chipDeselect is not ended, otherwise status of physical backend.
+	    * @brief Executes whole frame by combining (see SpiBus). Blocks until frame is executed by this or other thread.
+	    */
+            TransferStatus transact(std::span<const byte> tx, std::span<byte> rx) noexcept override;
+
+        private:
+	    /**
+	    * @brief Arbiter of shared bus.
+	    */
+            SpiBus& bus;
+
+	    /**
+	    * @brief Chip select line of chip.
+	    */
+            IChipSelect* line;
+
+	    /**
+	    * @brief Whether this handle owns bus now. Accessed by thread of handle only.
+	    */
+            bit owner{false};
+        };
+
+	/**
+	* @param backend physical backend: its SpiBus::transfer clocks shared data lines. Its chip select methods are not used.
+	* @brief Constructs arbiter of shared bus.
+	*/
+        explicit SpiBus(ISpiBitBang* backend) noexcept;
+
+	/**
+	* @brief Count of frames executed on bus.
+	*/
+        dword getFrameCount() const noexcept;
+
+	/**
+	* @brief Count of combining passes: frames queued by several threads and executed back-to-back count as one batch.
+	*/
+        dword getBatchCount() const noexcept;
+
+    private:
+	/**
+	* @struct Request
+	* @brief Queued single-transfer frame. Lives on stack of waiting thread.
+	*/
+        struct Request {
+            IChipSelect* line; ///< Chip select line of chip.
+            std::span<const byte> tx; ///< Bytes to send.
+            std::span<byte> rx; ///< Buffer for response.
+            TransferStatus status{TRANSFER_OK}; ///< Result of frame.
+            std::atomic<bool> done{false}; ///< Whether frame is executed.
+            Request* next{nullptr}; ///< Next queued request.
+        };
+
+	/**
+	* @brief Physical backend.
+	*/
+        ISpiBitBang* backend;
+
+	/**
+	* @brief Bus ownership. Held only while frames are on the wire, waiters sleep on it till release.
+	*/
+        std::atomic<bool> owned{false};
+
+	/**
+	* @brief Lock-free stack of queued requests (multiple producers, single consumer: bus owner).
+	*/
+        std::atomic<Request*> pending{nullptr};
+
+	/**
+	* @brief Count of executed frames.
+	*/
+        std::atomic<dword> frames{0};
+
+	/**
+	* @brief Count of combining passes.
+	*/
+        std::atomic<dword> batches{0};
+
+	/**
+	* @param request request to queue and wait for.
+	* @brief Queue request and wait until it is executed, executing queued requests while bus is free.
+	*/
+        void submit(Request& request) noexcept;
+
+	/**
+	* @brief Wait for bus and take it.
+	*/
+        void acquire() noexcept;
+
+	/**
+	* @brief Release bus and wake threads waiting for it.
+	*/
+        void release() noexcept;
+
+	/**
+	* @brief Execute all queued requests in arrival order. Must be called by bus owner.
+	*/
+        void drain() noexcept;
+
+	/**
+	* @param line chip select line of chip.
+	* @param tx bytes to send.
+	* @param rx buffer for response.
+	* @returns status of physical backend.
+	* @brief Execute single frame. Must be called by bus owner.
+	*/
+        TransferStatus execute(IChipSelect* line, std::span<const byte> tx, std::span<byte> rx) noexcept;
+    };
+
+#endif
@@ -11,7 +11,9 @@
     */
     #define SPI_INTERFACE_H
 
+    #include <concepts>
     #include <cstdint>
+    #include <span>
     #include <type_traits>
 
     /**
@@ -60,6 +62,29 @@
     template <typename T>
     using const_type = std::conditional_t<sizeof(void*) < sizeof(T), const T&, const T>;
 
+    /**
+    *   @enum TransferStatus
+    *   @brief Result of ISpiBitBang::transfer.
+    */
+    enum TransferStatus : byte {
+        TRANSFER_OK = 0, ///< Transfer is completed.
+        TRANSFER_INVALID_ARGUMENT, ///< Given buffers are not valid for request.
+        TRANSFER_INVALID_STATE, ///< Bus is not in state to transfer data. For example, device is not selected.
+        TRANSFER_DEVICE_BUSY, ///< Device is busy and rejects request.
+        TRANSFER_INVALID_INSTRUCTION, ///< Device does not support given instruction.
+        TRANSFER_NO_MEMORY ///< Not enough memory to complete transfer.
+    };
+
+    /**
+    *   @param status transfer status to validate.
+    *   @throw
+    *   - std::invalid_argument if @c status is TransferStatus::TRANSFER_INVALID_ARGUMENT.
+    *   - std::bad_alloc if @c status is TransferStatus::TRANSFER_NO_MEMORY.
+    *   - std::runtime_error if @c status is any other error.
+    *   @brief Converts ISpiBitBang::transfer error status into exception.
+    */
+    void validateTransferStatus(const_type<TransferStatus> status);
+
 
     /**
     *   @class ISpiBitBang
@@ -96,13 +121,44 @@
         */
         virtual byte transferByte(const_type<byte> data) = 0;
 
+	/**
+	* @param tx bytes to shift out into device.
+	* @param rx buffer for bytes shifted in from device.
+	* @returns TransferStatus::TRANSFER_OK or error status. Nothing is thrown and no memory is allocated.
+        * @brief Full-duplex transfer like SPI shift register does. <TT>max(tx.size(), rx.size())</TT> bytes are clocked:
+	* byte @c i of @c rx is received while byte @c i of @c tx is sent. Missing @c tx bytes are sent as 0x00, received bytes beyond @c rx are dropped.
+        */
+        virtual TransferStatus transfer(std::span<const byte> tx, std::span<byte> rx) noexcept = 0;
+
+	/**
+	* @param tx bytes to shift out into device.
+	* @param rx buffer for bytes shifted in from device.
+	* @returns See ISpiBitBang::transfer. Nothing is thrown, so chip select methods of implementation must not throw.
+	* @brief Executes whole single-transfer frame: sets @c SS low, transfers, sets @c SS high.
+	* Override to execute frames more efficiently, e.g. SpiBus::Device batches frames of different threads.
+	*/
+        virtual TransferStatus transact(std::span<const byte> tx, std::span<byte> rx) noexcept;
+
 	/**
 	* @param data byte array value to transfer.
 	* @param length byte count to transfer.
-	* @returns byte value. It's meaning can be assigned manually.
+	* @throw See validateTransferStatus.
+	* @returns bytes received while @c data was sent. Array of @c length bytes is allocated, it must be released manually using delete[].
         * @brief Transfers input byte array into device. 
+	* @deprecated Compatibility shim over ISpiBitBang::transfer. Allocates memory on every call.
         */
-        virtual byte_array transferBytes(const byte_array data, const_type<array_size> length) = 0;
+        byte_array transferBytes(const byte_array data, const_type<array_size> length);
+    };
+
+    /**
+    *   @concept SpiBackend
+    *   @brief Requirements to SPI backend used by drivers bound at compile time. Every ISpiBitBang implementation satisfies it.
+    */
+    template <typename T>
+    concept SpiBackend = requires(T& spi, std::span<const byte> tx, std::span<byte> rx) {
+        spi.chipSelect();
+        spi.chipDeselect();
+        { spi.transfer(tx, rx) } -> std::same_as<TransferStatus>;
     };
 
 #endif
@@ -0,0 +1,242 @@
+/**
+* @file spi_trace.h
+* @brief Provides recorder of SPI transactions into binary trace and replay of traces.
+*/
+
+#ifndef SPI_TRACE_H
+
+    /**
+    * @def SPI_TRACE_H
+    * @brief Include module macro.
+    */
+    #define SPI_TRACE_H
+
+    #include "result.h"
+    #include "spi_interface.h"
+
+    #include <chrono>
+    #include <memory>
+    #include <vector>
+
+    /**
+    * @enum TraceEvent
+    * @brief Type of trace record, low 2 bits of record header. Bit 7 of header is bit sent by TraceEvent::TRACE_BIT.
+    */
+    enum TraceEvent : byte {
+        TRACE_CHIP_SELECT = 0, ///< ISpiBitBang::chipSelect: @c SS is set high, frame ends.
+        TRACE_CHIP_DESELECT = 1, ///< ISpiBitBang::chipDeselect: @c SS is set low, frame starts.
+        TRACE_TRANSFER = 2, ///< ISpiBitBang::transfer: sent bytes and count of received bytes.
+        TRACE_BIT = 3 ///< ISpiBitBang::transferBit.
+    };
+
+    /**
+    * @struct SpiTraceStats
+    * @brief Summary of replayed trace.
+    */
+    struct SpiTraceStats {
+        dword events{0}; ///< Count of replayed records.
+        dword frames{0}; ///< Count of frames (chip select toggles).
+        dword transfers{0}; ///< Count of transfers of bytes and bits.
+        dword bytes{0}; ///< Count of clocked bytes: <TT>max(tx, rx)</TT> of every transfer.
+        std::chrono::nanoseconds recorded{0}; ///< Time span of trace on recorder's clock.
+    };
+
+    /**
+    * @class SpiTraceRecorder
+    * @brief ISpiBitBang decorator which forwards every call to wrapped backend and records it into binary ring buffer.
+    *
+    * Trace is <TT>"SPT1"</TT> magic followed by records. Record is header byte (see ::TraceEvent), time since previous record in nanoseconds
+    * and, for TraceEvent::TRACE_TRANSFER, count of sent bytes, sent bytes and count of received bytes. Counts and times are LEB128 varints,
+    * so byte read frame costs about 20 bytes of trace. Received bytes are not stored: replayed device produces them.
+    * Clock is read on chip select toggles only: transfers are stamped with time of their frame start, as bus clock defines time inside frame.
+    * When buffer is full the oldest records are dropped, so trace always holds the latest activity.
+    * @warning Recorder is not thread-safe: use it under the same lock as wrapped backend.
+    */
+    class SpiTraceRecorder final : public ISpiBitBang {
+    public:
+	/**
+	* @brief Default capacity of ring buffer in bytes.
+	*/
+        static constexpr array_size DEFAULT_CAPACITY = 64 * 1024;
+
+	/**
+	* @brief Magic bytes of trace.
+	*/
+        static constexpr byte MAGIC[4] = {'S', 'P', 'T', '1'};
+
+	/**
+	* @brief The longest transfer accepted by ::replaySpiTrace: capacity of the largest supported device (see NorFlash::MAX_CAPACITY).
+	*/
+        static constexpr array_size MAX_TRANSFER_SIZE = array_size{1} << 24;
+
+	/**
+	* @brief Size of stack buffer for received bytes of ::replaySpiTrace. Longer transfers are replayed by several calls inside the same frame.
+	*/
+        static constexpr array_size REPLAY_CHUNK_SIZE = 256;
+
+	/**
+	* @param spi wrapped backend.
+	* @param capacity capacity of ring buffer in bytes, rounded up to power of 2.
+	* @throw std::invalid_argument if spi == nullptr.
+	* @brief Constructs recorder. Time of the first record is counted from construction.
+	*/
+        explicit SpiTraceRecorder(ISpiBitBang* spi, const_type<array_size> capacity = DEFAULT_CAPACITY);
+
+	/**
+	* @brief Records and forwards call.
+	*/
+        void chipSelect() override;
+
+	/**
+	* @brief Records and forwards call.
+	*/
+        void chipDeselect() override;
+
+	/**
+	* @param data bit to send.
+	* @returns bit received by wrapped backend.
+	* @brief Records and forwards call.
+	*/
+        bit transferBit(const_type<bit> data) override;
+
+	/**
+	* @param data byte to send.
+	* @returns byte received by wrapped backend.
+	* @brief Records single byte transfer and forwards call.
+	*/
+        byte transferByte(const_type<byte> data) override;
+
+	/**
+	* @param tx bytes to send.
+	* @param rx buffer for received bytes.
+	* @returns status of wrapped backend.
+	* @brief Records and forwards call.
+	*/
+        TransferStatus transfer(std::span<const byte> tx, std::span<byte> rx) noexcept override;
+
+	/**
+	* @param tx bytes to send.
+	* @param rx buffer for received bytes.
+	* @returns status of wrapped backend.
+	* @brief Records frame as chip deselect, transfer and chip select and forwards call to <TT>ISpiBitBang::transact</TT> of wrapped backend.
+	*/
+        TransferStatus transact(std::span<const byte> tx, std::span<byte> rx) noexcept override;
+
+	/**
+	* @returns trace: magic and records from the oldest one. It is the format read by ::replaySpiTrace.
+	*/
+        std::vector<byte> snapshot() const;
+
+	/**
+	* @returns count of records in buffer.
+	*/
+        dword getRecordCount() const noexcept;
+
+	/**
+	* @returns count of records dropped because buffer was full or record was larger than buffer.
+	*/
+        dword getDroppedCount() const noexcept;
+
+	/**
+	* @brief Drops every record and resets counters.
+	*/
+        void clear() noexcept;
+
+    private:
+	/**
+	* @brief Maximum size of record before sent bytes: header, time and count of sent bytes.
+	*/
+        static constexpr byte MAX_RECORD_HEADER = 1 + 10 + 5;
+
+	/**
+	* @brief Maximum count of sent bytes of record encoded on stack and pushed into buffer by single copy. Instruction frames fit it.
+	*/
+        static constexpr byte INLINE_SIZE = 32;
+
+	/**
+	* @brief Wrapped backend.
+	*/
+        ISpiBitBang* spi;
+
+	/**
+	* @brief Ring buffer.
+	*/
+        std::unique_ptr<byte[]> buffer;
+
+	/**
+	* @brief Index mask of ring buffer: capacity - 1.
+	*/
+        array_size mask;
+
+	/**
+	* @brief Position of the next written byte. Positions grow monotonically, buffer index is <TT>position & mask</TT>.
+	*/
+        array_size head{0};
+
+	/**
+	* @brief Position of the oldest record.
+	*/
+        array_size tail{0};
+
+	/**
+	* @brief Count of records in buffer.
+	*/
+        dword records{0};
+
+	/**
+	* @brief Count of dropped records.
+	*/
+        dword dropped{0};
+
+	/**
+	* @brief Time of previous record.
+	*/
+        std::chrono::steady_clock::time_point last;
+
+	/**
+	* @param event type of record.
+	* @param now time of record.
+	* @param tx sent bytes of TraceEvent::TRACE_TRANSFER.
+	* @param rxLength count of received bytes of TraceEvent::TRACE_TRANSFER.
+	* @brief Auxiliary method to append record, the oldest records are dropped to make room.
+	*/
+        void record(const_type<byte> event, const std::chrono::steady_clock::time_point now, std::span<const byte> tx = {}, const_type<array_size> rxLength = 0) noexcept;
+
+	/**
+	* @param data bytes to append.
+	* @param length count of bytes.
+	* @brief Auxiliary method to copy bytes into ring buffer at head.
+	*/
+        void push(const byte* data, const_type<array_size> length) noexcept;
+
+	/**
+	* @returns size of the oldest record.
+	* @brief Auxiliary method to decode size of record at tail.
+	*/
+        array_size record_size() const noexcept;
+
+	/**
+	* @param value value to encode.
+	* @param out buffer for at least 10 bytes.
+	* @return count of written bytes.
+	* @brief Auxiliary method to encode LEB128 varint: 7 bits per byte, bit 7 is set on every byte but the last.
+	*/
+        static byte encode_varint(unsigned long long value, byte* out) noexcept;
+    };
+
+    /**
+    * @param trace trace of SpiTraceRecorder::snapshot.
+    * @param spi backend which receives calls of trace, e.g. MockSpi.
+    * @return
+    * - statistics of replayed trace.
+    * - ErrorCode::ERROR_INVALID_ARGUMENT if trace has no magic, ends in the middle of record or has transfer longer than SpiTraceRecorder::MAX_TRANSFER_SIZE.
+    * - ErrorCode::ERROR_INVALID_STATE if @c spi can't transfer single bit (its ISpiBitBang::transferBit throws).
+    * - error of ISpiBitBang::transfer status of @c spi (see ::toErrorCode).
+    * - ErrorCode::ERROR_NO_BACKEND if spi == nullptr.
+    *
+    * Records before error are replayed.
+    * @brief Replays calls of trace at full speed: recorded times are reported, not awaited. Records before the first chip deselect belong to frame
+    * cut by full ring of recorder: they are counted as events but not replayed. Received bytes are dropped into stack buffer, no memory is allocated.
+    */
+    Result<SpiTraceStats> replaySpiTrace(std::span<const byte> trace, ISpiBitBang* spi);
+#endif
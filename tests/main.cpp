@@ -3,9 +3,20 @@
 * @brief Main file for testing.
 */
 
+#include "../src/include/eeprom_25lc040a_cache.h"
+#include "../src/include/eeprom_25lc040a_counter.h"
+#include "../src/include/eeprom_25lc040a_kv_store.h"
+#include "../src/include/eeprom_25xx_scheduler.h"
+#include "../src/include/eeprom_25xx_streambuf.h"
+#include "../src/include/mock_nor_flash.h"
+#include "../src/include/mock_spi_bus.h"
 #include "../src/include/mock_spi_driver.h"
+#include "../src/include/mock_spi_pins.h"
+#include "../src/include/spi_trace.h"
 #include "test_runner.h"
 #include <cassert>
+#include <filesystem>
+#include <thread>
 
 /* 
 * @def INVALID_TEST_RUN
@@ -33,6 +44,16 @@ void testReadByte();
 */
 void testReadByteArray();
 
+/**
+* @brief Execute test to read byte array into caller provided buffer.
+*/
+void testReadInto();
+
+/**
+* @brief Execute test of ISpiBitBang::transferBytes compatibility shim.
+*/
+void testTransferBytesShim();
+
 /**
 * @brief Execute test to write bit at bad address.
 */
@@ -43,6 +64,11 @@ void testWriteBadAddress();
 */
 void testWriteBit();
 
+/**
+* @brief Execute test to write and read bit range crossing page boundary.
+*/
+void testWriteBits();
+
 /**
 * @brief Execute test to write byte.
 */
@@ -53,6 +79,121 @@ void testWriteByte();
 */
 void testWriteByteArray();
 
+/**
+* @brief Execute test to write byte array skipping unchanged pages.
+*/
+void testWriteSkipUnchanged();
+
+/**
+* @brief Execute test that emulated device wraps written data inside page.
+*/
+void testWritePageWrap();
+
+/**
+* @brief Execute test to write whole device image with page bursts.
+*/
+void testWriteImageWriteCycles();
+
+/**
+* @brief Execute test of driver bound to MockSpi at compile time.
+*/
+void testBasicDriver();
+
+/**
+* @brief Execute test of 25LC256 driver and mock made from the same device traits.
+*/
+void testTraitsDevice();
+
+/**
+* @brief Execute test that mock with memory mapped image keeps device state between runs.
+*/
+void testMockImagePersistence();
+
+/**
+* @brief Execute test of bus cycle cost model of mock: frame overhead, write cycle and throughput on virtual clock.
+*/
+void testBusCostModel();
+
+/**
+* @brief Execute test that virtual clock never goes backwards on back-to-back frames during write cycle and doesn't depend on real time write cycle.
+*/
+void testVirtualClockMonotonic();
+
+/**
+* @brief Execute test that asynchronous write returns before write cycle ends and caller's work overlaps it.
+*/
+void testAsyncWriteOverlap();
+
+/**
+* @brief Execute test that write-back cache collapses repeated writes into one write cycle per page.
+*/
+void testCacheWriteBack();
+
+/**
+* @brief Execute test that stream over region writes and reads whole pages at once, seeks within region and fails at region end.
+*/
+void testStreambuf();
+
+/**
+* @brief Execute test that key-value store appends one record per update, rebuilds index on mount and compacts full segment.
+*/
+void testKvStore();
+
+/**
+* @brief Execute test that wear-distributed counter writes single byte per increment and recovers value by single read.
+*/
+void testCounter();
+
+/**
+* @brief Execute test of STATUS register: block protection bits are written and respected, write cycles are awaited with few polls.
+*/
+void testStatusRegister();
+
+/**
+* @brief Execute test of exception-free API: failures are reported by error codes which throwing API converts into the same exceptions.
+*/
+void testResultApi();
+
+/**
+* @brief Execute test of driver statistics: outermost operations are counted with their bytes, frames, instructions and latencies.
+*/
+void testDriverStats();
+
+/**
+* @brief Execute test that scattered reads are merged into runs read by single frame and scattered writes share page bursts.
+*/
+void testVectored();
+
+/**
+* @brief Execute test of NOR flash page-split programming and streaming read.
+*/
+void testNorProgramRead();
+
+/**
+* @brief Execute test that NOR flash erase picks the largest erase units and takes their time.
+*/
+void testNorErase();
+
+/**
+* @brief Execute test of several threads driving EEPROMs and NOR flash on one shared bus: data is intact, frames never collide.
+*/
+void testBusArbiterThreads();
+
+/**
+* @brief Execute test that scheduler keeps arrival order of requests, coalesces writes of concurrent threads into page bursts and rejects invalid requests.
+*/
+void testScheduler();
+
+/**
+* @brief Execute test of bit-bang backend over pin-level device in SPI modes 0 and 3 and of its bit order and edge count.
+*/
+void testBitBang();
+
+/**
+* @brief Execute test that recorded trace replayed on another device reproduces its content and frames, and that full ring keeps the latest records.
+*/
+void testSpiTrace();
+
 /**
 * @ brief Entry point to programm.
 */
@@ -66,13 +207,52 @@ int main() {
     runner.runTest("ReadBit", testReadBit);
     runner.runTest("ReadByte", testReadByte);
     runner.runTest("ReadByteArray", testReadByteArray);
+    runner.runTest("ReadInto", testReadInto);
+    runner.runTest("TransferBytesShim", testTransferBytesShim);
 
     #ifdef INVALID_TEST_RUN
         runner.runTest("WriteInvalidAddress", testWriteBadAddress);
     #endif
     runner.runTest("WriteBit", testWriteBit);
+    runner.runTest("WriteBits", testWriteBits);
     runner.runTest("WriteByte", testWriteByte);
-    //runner.runTest("WriteByteArray", testWriteByteArray);
+    runner.runTest("WriteByteArray", testWriteByteArray);
+    runner.runTest("WriteSkipUnchanged", testWriteSkipUnchanged);
+    runner.runTest("WritePageWrap", testWritePageWrap);
+    runner.runTest("WriteImageWriteCycles", testWriteImageWriteCycles);
+
+    runner.runTest("BasicDriver", testBasicDriver);
+    runner.runTest("TraitsDevice", testTraitsDevice);
+    runner.runTest("MockImagePersistence", testMockImagePersistence);
+    runner.runTest("BusCostModel", testBusCostModel);
+    runner.runTest("VirtualClockMonotonic", testVirtualClockMonotonic);
+    runner.runTest("AsyncWriteOverlap", testAsyncWriteOverlap);
+    runner.runTest("StatusRegister", testStatusRegister);
+    runner.runTest("ResultApi", testResultApi);
+    runner.runTest("DriverStats", testDriverStats);
+    runner.runTest("Vectored", testVectored);
+
+    // === CACHE tests
+    runner.runTest("CacheWriteBack", testCacheWriteBack);
+    runner.runTest("Streambuf", testStreambuf);
+
+    // === KEY-VALUE STORE tests
+    runner.runTest("KvStore", testKvStore);
+    runner.runTest("Counter", testCounter);
+
+    // === NOR FLASH tests
+    runner.runTest("NorProgramRead", testNorProgramRead);
+    runner.runTest("NorErase", testNorErase);
+
+    // === BUS tests
+    runner.runTest("BusArbiterThreads", testBusArbiterThreads);
+    runner.runTest("Scheduler", testScheduler);
+
+    // === BIT-BANG tests
+    runner.runTest("BitBang", testBitBang);
+
+    // === TRACE tests
+    runner.runTest("SpiTrace", testSpiTrace);
 }
 
 void testReadBadAddress() {
@@ -144,6 +324,53 @@ void testReadByteArray() {
         assert(result[i] == response[i]);
 }
 
+void testReadInto() {
+    MockSpi spi;
+    const pointer_size ADDRESS = std::rand() % 512; // random address [0; 511]
+    const array_size length = std::rand() % 256 + 1; // random response array size [1; 256]
+
+    byte expected[256];
+    for (array_size i = 0; i < length; ++i)
+        expected[i] = std::rand() % 256; // random byte value
+
+    spi.setByteArrayByAddress(ADDRESS, expected, length);
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+
+    // "Read" byte array into stack buffer
+    byte result[256];
+    eeprom.readInto(ADDRESS, std::span<byte>(result, length));
+
+    // Assert result
+    for (array_size i = 0; i < length; ++i)
+        assert(result[i] == expected[i]);
+
+    // "Read" single byte
+    byte value;
+    eeprom.readInto(ADDRESS, value);
+    assert(value == expected[0]);
+}
+
+void testTransferBytesShim() {
+    MockSpi spi;
+    const pointer_size ADDRESS = std::rand() % 512; // random address [0; 511]
+    const byte VALUE = std::rand() % 256; // random byte value
+
+    spi.setByteArrayByAddress(ADDRESS, const_cast<byte_array>(&VALUE), 1);
+
+    // CMD_READ of 1 byte: A8 is bit 3 of instruction byte, data is received as 3rd byte of frame
+    byte arr[3] = {static_cast<byte>(EEPROM_25LC040A::CMD_READ | (ADDRESS & 0x100) >> 5), static_cast<byte>(ADDRESS & 0xFF), 0};
+
+    spi.chipDeselect();
+    const auto response = spi.transferBytes(arr, sizeof(arr));
+    spi.chipSelect();
+
+    // Assert result
+    assert(response[2] == VALUE);
+    delete[] response;
+}
+
 void testWriteBadAddress() {
     MockSpi spi;
     const pointer_size ADDRESS = EEPROM_25LC040A::MAX_ADDRESS + 1; // invalid address
@@ -176,6 +403,43 @@ void testWriteBit() {
     assert(v == VALUE);
 }
 
+void testWriteBits() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    const pointer_size ADDRESS = 2 * EEPROM_25LC040A::PAGE_SIZE - 4; // 64 bits cross page boundary
+    const byte OFFSET = 3;
+
+    byte image[EEPROM_25LC040A::MAX_ADDRESS + 1];
+    for (auto& value : image)
+        value = std::rand() % 256; // random byte value
+    spi.setByteArrayByAddress(0, image, sizeof(image));
+
+    bit flags[64];
+    for (auto& flag : flags)
+        flag = std::rand() % 2; // random bit
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+
+    // "Write" 64 flags: one write cycle per affected page
+    eeprom.writeBits(ADDRESS, OFFSET, flags);
+    assert(spi.getWriteCycleCount() == 2);
+
+    // Assert written bits and preserved neighbours
+    const auto result = spi.getByteArrayByAddress(0);
+    for (bit_index i = 0; i < (EEPROM_25LC040A::MAX_ADDRESS + 1) * 8; ++i) {
+        const bit actual = result[i / 8] >> (7 - i % 8) & 1;
+        const bit_index first = ADDRESS * 8 + OFFSET;
+        const bit expected = i >= first && i < first + 64 ? flags[i - first] : image[i / 8] >> (7 - i % 8) & 1;
+        assert(actual == expected);
+    }
+
+    // "Read" flags back by flat index
+    bit read[64];
+    eeprom.readBits(ADDRESS * 8 + OFFSET, read);
+    for (byte i = 0; i < 64; ++i)
+        assert(read[i] == flags[i]);
+}
 
 void testWriteByte() {
     MockSpi spi;
@@ -197,7 +461,7 @@ void testWriteByte() {
 void testWriteByteArray() {
     MockSpi spi;
     const pointer_size ADDRESS = std::rand() % 512; // random address [0; 511]
-    const array_size length = std::rand() % 256; // random response array size
+    const array_size length = std::rand() % 256 + 1; // random response array size [1; 256]
 
     byte* response = new (std::nothrow) byte[length];
     if (!response)
@@ -211,10 +475,1063 @@ void testWriteByteArray() {
     // "Write" byte array
     eeprom.writeByteArray(ADDRESS, response, length);
 
-    // Assert record result
-    const auto result = spi.getByteArrayByAddress(ADDRESS);
+    // Assert record result. Data wraps at EEPROM_25LC040A::MAX_ADDRESS.
+    const auto result = spi.getByteArrayByAddress(0);
 
     // Assert result
-    for (array_size i = 0; i < length - 2; ++i)
-        assert(result[i] == response[i]);;
+    for (array_size i = 0; i < length; ++i)
+        assert(result[(ADDRESS + i) % (EEPROM_25LC040A::MAX_ADDRESS + 1)] == response[i]);
+
+    delete[] response;
+}
+
+void testWriteSkipUnchanged() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    constexpr array_size LENGTH = EEPROM_25LC040A::MAX_ADDRESS + 1;
+    constexpr pointer_size PAGES = LENGTH / EEPROM_25LC040A::PAGE_SIZE;
+
+    byte image[LENGTH];
+    for (array_size i = 0; i < LENGTH; ++i)
+        image[i] = std::rand() % 256; // random byte value
+    spi.setByteArrayByAddress(0, image, LENGTH);
+
+    // Change bytes in two different pages
+    image[5] ^= 0xFF;
+    image[LENGTH - 1] ^= 0x01;
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+
+    // "Write" whole device: only two pages differ
+    const auto skipped = eeprom.writeByteArray(0, image, LENGTH, EEPROM_25LC040A::WRITE_SKIP_UNCHANGED);
+    assert(skipped == PAGES - 2);
+    assert(spi.getWriteCycleCount() == 2);
+
+    const auto result = spi.getByteArrayByAddress(0);
+    for (array_size i = 0; i < LENGTH; ++i)
+        assert(result[i] == image[i]);
+
+    // "Write" the same image again: nothing is written
+    assert(eeprom.writeByteArray(0, image, LENGTH, EEPROM_25LC040A::WRITE_SKIP_UNCHANGED) == PAGES);
+    assert(spi.getWriteCycleCount() == 2);
+}
+
+void testWritePageWrap() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    const pointer_size ADDRESS = 3 * EEPROM_25LC040A::PAGE_SIZE + 12; // 4 bytes before page end
+
+    // Raw CMD_WREN and CMD_WRITE instructions with 8 bytes which cross page boundary
+    const byte wren[1] = {EEPROM_25LC040A::CMD_WREN};
+    spi.chipDeselect();
+    assert(spi.transfer(wren, {}) == TRANSFER_OK);
+    spi.chipSelect();
+
+    const byte arr[2 + 8] = {static_cast<byte>(EEPROM_25LC040A::CMD_WRITE | (ADDRESS & 0x100) >> 5), static_cast<byte>(ADDRESS & 0xFF), 1, 2, 3, 4, 5, 6, 7, 8};
+    spi.chipDeselect();
+    assert(spi.transfer(arr, {}) == TRANSFER_OK);
+    spi.chipSelect();
+
+    // Last 4 bytes are wrapped to the beginning of the same page, next page is untouched
+    const auto result = spi.getByteArrayByAddress(0);
+    const pointer_size PAGE = ADDRESS - ADDRESS % EEPROM_25LC040A::PAGE_SIZE;
+    for (byte i = 0; i < 4; ++i) {
+        assert(result[ADDRESS + i] == i + 1);
+        assert(result[PAGE + i] == i + 5);
+        assert(result[PAGE + EEPROM_25LC040A::PAGE_SIZE + i] == 0);
+    }
+    assert(spi.getWriteCycleCount() == 1);
+}
+
+void testWriteImageWriteCycles() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{100});
+    constexpr array_size LENGTH = EEPROM_25LC040A::MAX_ADDRESS + 1;
+
+    byte image[LENGTH];
+    for (array_size i = 0; i < LENGTH; ++i)
+        image[i] = std::rand() % 256; // random byte value
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+
+    // "Write" whole device
+    eeprom.writeByteArray(0, image, LENGTH);
+
+    // Assert one write cycle per page
+    assert(spi.getWriteCycleCount() == LENGTH / EEPROM_25LC040A::PAGE_SIZE);
+
+    const auto result = spi.getByteArrayByAddress(0);
+    for (array_size i = 0; i < LENGTH; ++i)
+        assert(result[i] == image[i]);
+}
+
+void testBasicDriver() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    const pointer_size ADDRESS = std::rand() % 512; // random address [0; 511]
+    const byte VALUE = std::rand() % 256; // random byte value
+
+    // Make EEPROM bound to MockSpi
+    BasicEEPROM_25LC040A<MockSpi> eeprom(&spi);
+
+    // "Write" and "read" byte
+    eeprom.writeByte(ADDRESS, VALUE);
+    assert(eeprom.readByte(ADDRESS) == VALUE);
+    assert(spi.getByteArrayByAddress(ADDRESS)[0] == VALUE);
+}
+
+void testTraitsDevice() {
+    using Device = BasicEEPROM_25xx<EEPROM_25LC256_Traits, BasicMockSpi<EEPROM_25LC256_Traits>>;
+    static_assert(Device::MAX_ADDRESS == 32767 && Device::PAGE_SIZE == 64);
+
+    BasicMockSpi<EEPROM_25LC256_Traits> spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    constexpr array_size LENGTH = Device::MAX_ADDRESS + 1;
+
+    byte image[LENGTH];
+    for (array_size i = 0; i < LENGTH; ++i)
+        image[i] = std::rand() % 256; // random byte value
+
+    // Make EEPROM
+    Device eeprom(&spi);
+
+    // "Write" whole device
+    eeprom.writeByteArray(0, image, LENGTH);
+
+    // Assert one write cycle per page
+    assert(spi.getWriteCycleCount() == LENGTH / Device::PAGE_SIZE);
+
+    // "Read" whole device back in windows
+    byte result[LENGTH];
+    eeprom.readInto(0, std::span<byte>(result, LENGTH));
+    for (array_size i = 0; i < LENGTH; ++i)
+        assert(result[i] == image[i]);
+
+    // Bits above 9 bits address are reached
+    const pointer_size ADDRESS = 0x7FF0 + std::rand() % 16; // random address [32752; 32767]
+    eeprom.writeByte(ADDRESS, ~image[ADDRESS]);
+    assert(eeprom.readByte(ADDRESS) == byte(~image[ADDRESS]));
+}
+
+void testVirtualClockMonotonic() {
+    using namespace std::chrono_literals;
+    const auto run = [](const std::chrono::microseconds realCycle) {
+        MockSpi spi;
+        spi.setWriteCycleTime(realCycle);
+        spi.setBusFrequency(10000000); // 100 ns per clock
+        const auto frame = [&](std::initializer_list<byte> tx) {
+            byte rx[4];
+            spi.chipDeselect();
+            spi.transfer(std::span<const byte>(tx.begin(), tx.size()), std::span<byte>(rx, tx.size()));
+            spi.chipSelect();
+        };
+
+        // WREN and WRITE start write cycle, then polls and reads follow back-to-back
+        frame({EEPROM_25xx::CMD_WREN});
+        frame({EEPROM_25xx::CMD_WRITE, 0x10, 0xA5});
+        const auto written = spi.getElapsedTime();
+        assert(written == 2 * MockSpi::CS_TIME + 4 * 8 * 100ns + MockSpi::WRITE_CYCLE_TIME);
+        auto previous = written;
+        for (byte i = 0; i < 8; ++i) {
+            if (i % 2)
+                frame({EEPROM_25xx::CMD_READ, 0x10, 0});
+            else
+                frame({EEPROM_25xx::CMD_RDSR, 0});
+            assert(spi.getElapsedTime() >= previous);
+            previous = spi.getElapsedTime();
+        }
+
+        // The first poll overlaps write cycle, the first read starts after its end and next frames follow it
+        assert(previous == written + 3 * (MockSpi::CS_TIME + 2 * 8 * 100ns) + 4 * (MockSpi::CS_TIME + 3 * 8 * 100ns));
+        return previous;
+    };
+
+    // Emulated real time write cycle doesn't change virtual clock
+    assert(run(0us) == run(std::chrono::microseconds{1000000}));
+}
+
+void testMockImagePersistence() {
+    const std::string IMAGE = (std::filesystem::temp_directory_path() / "eeprom_25lc040a_test.img").string();
+    std::filesystem::remove(IMAGE);
+    const pointer_size ADDRESS = std::rand() % 512; // random address [0; 511]
+    byte data[EEPROM_25LC040A::PAGE_SIZE];
+    for (pointer_size i = 0; i < EEPROM_25LC040A::PAGE_SIZE; ++i)
+        data[i] = std::rand() % 256; // random byte value
+
+    // First "run": new image is zeroed, written data goes to image file
+    {
+        MockSpi spi(IMAGE.c_str());
+        spi.setWriteCycleTime(std::chrono::microseconds{0});
+        EEPROM_25LC040A eeprom(&spi);
+
+        assert(eeprom.readByte(ADDRESS) == 0);
+        eeprom.writeByteArray(ADDRESS, data, EEPROM_25LC040A::PAGE_SIZE);
+    }
+    assert(std::filesystem::file_size(IMAGE) == EEPROM_25LC040A::MAX_ADDRESS + 1);
+
+    // Second "run": state is mapped from image, wrapping range is read back
+    {
+        MockSpi spi(IMAGE.c_str());
+        EEPROM_25LC040A eeprom(&spi);
+
+        byte result[EEPROM_25LC040A::PAGE_SIZE];
+        eeprom.readInto(ADDRESS, result);
+        for (pointer_size i = 0; i < EEPROM_25LC040A::PAGE_SIZE; ++i)
+            assert(result[i] == data[i]);
+    }
+    std::filesystem::remove(IMAGE);
+}
+
+void testBusCostModel() {
+    using namespace std::chrono_literals;
+    MockSpi spi;
+    spi.setWriteCycleTime(0us);
+    spi.setBusFrequency(10000000); // 100 ns per clock
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+
+    // Single frame: 2 bytes of instruction and 16 bytes of data
+    byte buffer[16];
+    eeprom.readInto(0, buffer);
+    assert(spi.getElapsedTime() == MockSpi::CS_TIME + 18 * 8 * 100ns);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_READ).transactions == 1);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_READ).payload == 16);
+
+    // WREN (1 byte), WRITE (3 bytes), write cycle. RDSR (2 bytes) overlaps write cycle
+    spi.resetBusStats();
+    eeprom.writeByte(0, 0xA5);
+    assert(spi.getElapsedTime() == 2 * MockSpi::CS_TIME + 4 * 8 * 100ns + MockSpi::WRITE_CYCLE_TIME);
+    assert(spi.getBusStats().transactions == 3);
+    assert(spi.getBusStats().busyTime == MockSpi::WRITE_CYCLE_TIME);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_WRITE).payload == 1);
+
+    // Page bursts are dominated by write cycle: bytes per simulated second
+    spi.resetBusStats();
+    byte image[EEPROM_25LC040A::MAX_ADDRESS + 1]{};
+    eeprom.writeByteArray(0, image, sizeof(image));
+    const double seconds = std::chrono::duration<double>(spi.getElapsedTime()).count();
+    const double throughput = spi.getBusStats(EEPROM_25xx::CMD_WRITE).payload / seconds;
+    assert(throughput > 3000 && throughput < EEPROM_25LC040A::PAGE_SIZE / 0.005);
+
+    // Whole device is read by single frame: address rolls over, no per-chunk instruction
+    spi.resetBusStats();
+    eeprom.readInto(0, image);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_READ).transactions == 1);
+    assert(spi.getElapsedTime() == MockSpi::CS_TIME + (2 + sizeof(image)) * 8 * 100ns);
+
+    // Frame may be clocked by parts: instruction, then data from A8 page
+    byte part[2] = {static_cast<byte>(EEPROM_25LC040A::CMD_READ | 0x08), 0x02};
+    spi.setByteArrayByAddress(0x102, part, 2);
+    spi.chipDeselect();
+    assert(spi.transfer(part, {}) == TRANSFER_OK);
+    assert(spi.transfer({}, part) == TRANSFER_OK);
+    spi.chipSelect();
+    assert(part[0] == (EEPROM_25LC040A::CMD_READ | 0x08) && part[1] == 0x02);
+}
+
+void testAsyncWriteOverlap() {
+    using namespace std::chrono_literals;
+    constexpr auto CYCLE = 20ms;
+    MockSpi spi;
+    spi.setWriteCycleTime(CYCLE);
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+    const byte DATA[4] = {0x11, 0x22, 0x33, 0x44};
+
+    // Write returns while device is still busy, single poll tells it
+    auto start = std::chrono::steady_clock::now();
+    auto future = eeprom.writeAsync(3, DATA);
+    assert(std::chrono::steady_clock::now() - start < CYCLE);
+    assert(!future.ready());
+    assert(spi.getBusStats(EEPROM_25xx::CMD_RDSR).transactions == 1);
+
+    // Work overlaps write cycle: no polling is needed after it
+    std::this_thread::sleep_for(CYCLE);
+    assert(future.ready());
+    assert(future.ready());
+    assert(spi.getBusStats(EEPROM_25xx::CMD_RDSR).transactions == 2);
+    future.wait();
+    assert(spi.getBusStats(EEPROM_25xx::CMD_RDSR).transactions == 2);
+
+    // The next operation waits for write cycle itself
+    const byte NEXT[2] = {0xAB, 0xCD};
+    start = std::chrono::steady_clock::now();
+    eeprom.writeAsync(15, NEXT);
+    assert(eeprom.readByte(16) == 0xCD);
+    assert(std::chrono::steady_clock::now() - start >= CYCLE);
+
+    // Write and work take one write cycle instead of two
+    start = std::chrono::steady_clock::now();
+    eeprom.writeAsync(0, DATA);
+    std::this_thread::sleep_for(CYCLE);
+    assert(eeprom.readByte(3) == 0x44);
+    assert(std::chrono::steady_clock::now() - start < 2 * CYCLE);
+    assert(spi.getWriteCycleCount() == 4);
+}
+
+void testStatusRegister() {
+    using namespace std::chrono_literals;
+    MockSpi spi;
+    spi.setWriteCycleTime(0us);
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+    assert(eeprom.readStatus() == 0);
+    assert(eeprom.getBlockProtection() == EEPROM_25xx::PROTECT_NONE);
+
+    // Upper half is protected: bits are non-volatile, so CMD_WRSR takes write cycle, WEL is reset after it
+    eeprom.setBlockProtection(EEPROM_25xx::PROTECT_UPPER_HALF);
+    assert(spi.getWriteCycleCount() == 1);
+    assert(eeprom.readStatus() == EEPROM_25xx::SR_BP1);
+    assert(eeprom.getBlockProtection() == EEPROM_25xx::PROTECT_UPPER_HALF);
+    static_assert(EEPROM_25LC040A::protectedFrom(EEPROM_25xx::PROTECT_UPPER_HALF) == 0x100);
+
+    // Writes into protected half are ignored by device
+    eeprom.writeByte(0xFF, 0xAA);
+    eeprom.writeByte(0x100, 0xAA);
+    assert(spi.getByteArrayByAddress(0xFF)[0] == 0xAA);
+    assert(spi.getByteArrayByAddress(0x100)[0] == 0);
+    assert(spi.getWriteCycleCount() == 2);
+
+    // Reserved bits are not written, protection is removed
+    eeprom.writeStatus(0xF0);
+    assert(eeprom.getBlockProtection() == EEPROM_25xx::PROTECT_NONE);
+    eeprom.writeByte(0x100, 0xAA);
+    assert(spi.getByteArrayByAddress(0x100)[0] == 0xAA);
+
+    // Adaptive polling: after the first cycles driver sleeps most of cycle instead of spinning
+    constexpr auto CYCLE = 2ms;
+    spi.setWriteCycleTime(CYCLE);
+    for (byte i = 0; i < 4; ++i)
+        eeprom.writeByte(i, i);
+    const dword polls = spi.getBusStats(EEPROM_25xx::CMD_RDSR).transactions;
+    const auto start = std::chrono::steady_clock::now();
+    for (byte i = 0; i < 8; ++i)
+        eeprom.writeByte(i, i + 1);
+    assert(std::chrono::steady_clock::now() - start >= 8 * CYCLE);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_RDSR).transactions - polls <= 8 * 10);
+    assert(eeprom.readByte(7) == 8);
+}
+
+void testResultApi() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+
+    // Make EEPROM
+    EEPROM_25LC040A eeprom(&spi);
+
+    // Success carries value
+    const byte DATA[] = {1, 2, 3, 4};
+    const Result<pointer_size> skipped = eeprom.tryWriteByteArray(0x1FE, DATA, EEPROM_25xx::WRITE_SKIP_UNCHANGED);
+    assert(skipped.ok() && skipped.value() == 0);
+    assert(eeprom.tryReadByte(0x1FF).value() == 2);
+    assert(eeprom.tryReadBit(0x001).value() == 0);
+    byte buffer[4];
+    assert(eeprom.tryReadInto(0x1FE, buffer).ok());
+    assert(!std::memcmp(buffer, DATA, sizeof(DATA)));
+    assert(eeprom.tryWriteByte(0x10, 0x80).ok());
+    assert(eeprom.tryReadBit(0x10).value() == 1);
+    assert(eeprom.tryReadStatus().value() == 0);
+
+    // Failures carry error codes, bus isn't used
+    spi.resetBusStats();
+    assert(eeprom.tryReadByte(EEPROM_25LC040A::MAX_ADDRESS + 1).error() == ERROR_OUT_OF_RANGE);
+    assert(eeprom.tryWriteByte(EEPROM_25LC040A::MAX_ADDRESS + 1, 0).error() == ERROR_OUT_OF_RANGE);
+    assert(eeprom.tryReadInto(0, std::span<byte>()).error() == ERROR_INVALID_ARGUMENT);
+    assert(eeprom.tryWriteByteArray(0, std::span<const byte>()).error() == ERROR_INVALID_ARGUMENT);
+    assert(eeprom.tryReadByte(EEPROM_25LC040A::MAX_ADDRESS + 1).valueOr(0xEE) == 0xEE);
+    eeprom.stop();
+    assert(eeprom.tryWriteByte(0, 0).error() == ERROR_STOPPED);
+    assert(eeprom.tryWriteAsync(0, DATA).error() == ERROR_STOPPED);
+    eeprom.resume();
+    assert(spi.getBusStats().transactions == 0);
+
+    const EEPROM_25LC040A detached(nullptr);
+    assert(detached.tryReadByte(0).error() == ERROR_NO_BACKEND);
+    assert(detached.tryReadStatus().error() == ERROR_NO_BACKEND);
+
+    // Throwing API throws the same exception types
+    bool thrown = false;
+    try {
+        eeprom.readByte(EEPROM_25LC040A::MAX_ADDRESS + 1);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        eeprom.writeByteArray(0, nullptr, 1);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        detached.readByte(0);
+    } catch (const std::runtime_error& error) {
+        thrown = std::string(error.what()) == std::string("EEPROM_25xx::readByte(): ") + describeError(ERROR_NO_BACKEND);
+    }
+    assert(thrown);
+
+    // Byte-level transfer of mock is a single byte frame: read data follows instruction
+    spi.chipDeselect();
+    spi.transferByte(EEPROM_25xx::CMD_READ | 0x08);
+    spi.transferByte(0xFE);
+    assert(spi.transferByte(0) == 1);
+    spi.chipSelect();
+}
+
+void testDriverStats() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+
+    // Statistics take no space unless enabled
+    static_assert(sizeof(BasicEEPROM_25LC040A<MockSpi>) < sizeof(BasicEEPROM_25LC040A<MockSpi, DriverStats>));
+    static_assert(std::is_empty_v<NoDriverStats>);
+
+    // Make EEPROM with statistics and reader which snapshots them concurrently
+    InstrumentedEEPROM_25LC040A eeprom(&spi);
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        dword calls = 0;
+        while (!done.load()) {
+            const dword now = eeprom.getStats().snapshot().operations[OP_READ_BYTE].calls;
+            assert(now >= calls);
+            calls = now;
+        }
+    });
+
+    // Two page bursts, byte reads (one of them fails) and bulk read
+    byte data[2 * EEPROM_25LC040A::PAGE_SIZE];
+    for (pointer_size i = 0; i < sizeof(data); ++i)
+        data[i] = i;
+    eeprom.writeByteArray(0, data, sizeof(data));
+    for (pointer_size i = 0; i < 100; ++i)
+        eeprom.readByte(i);
+    assert(!eeprom.tryReadByte(EEPROM_25LC040A::MAX_ADDRESS + 1).ok());
+    byte buffer[16];
+    eeprom.readInto(0, buffer);
+    done = true;
+    reader.join();
+
+    const DriverStatsSnapshot stats = eeprom.getStats().snapshot();
+    const OperationStats& reads = stats.operations[OP_READ_BYTE];
+    assert(reads.calls == 101 && reads.errors == 1 && reads.bytes == 100 && reads.transactions == 100);
+
+    // Nested readInto of readByte is not counted as its own call
+    const OperationStats& bulk = stats.operations[OP_READ_INTO];
+    assert(bulk.calls == 1 && bulk.bytes == sizeof(buffer) && bulk.transactions == 1);
+
+    // Write enables, page bursts and STATUS polls are counted by instruction and attributed to write
+    const OperationStats& writes = stats.operations[OP_WRITE_BYTE_ARRAY];
+    assert(stats.instructions[EEPROM_25xx::CMD_WREN] == 2 && stats.instructions[EEPROM_25xx::CMD_WRITE] == 2);
+    assert(stats.instructions[EEPROM_25xx::CMD_WRDI] == 0);
+    assert(writes.calls == 1 && writes.bytes == sizeof(data));
+    assert(writes.transactions == 4 + stats.instructions[EEPROM_25xx::CMD_RDSR]);
+    assert(stats.operations[OP_WRITE_CYCLE].calls == 2);
+    assert(stats.instructions[EEPROM_25xx::CMD_READ] == 101);
+
+    // Every call lands in latency histogram
+    dword histogram = 0;
+    for (const dword count : reads.latency)
+        histogram += count;
+    assert(histogram == reads.calls);
+    assert(reads.percentile(0.5) > std::chrono::nanoseconds{0} && reads.percentile(0.5) <= reads.percentile(1));
+
+    eeprom.resetStats();
+    assert(eeprom.getStats().snapshot().operations[OP_READ_BYTE].calls == 0);
+}
+
+void testVectored() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    EEPROM_25LC040A eeprom(&spi);
+    byte image[EEPROM_25LC040A::MAX_ADDRESS + 1];
+    for (pointer_size i = 0; i <= EEPROM_25LC040A::MAX_ADDRESS; ++i)
+        image[i] = static_cast<byte>(i * 7 + 3);
+    eeprom.writeByteArray(0, image, sizeof(image));
+
+    // Unsorted fields: two runs within gap, overlapping and nested fields, one distant field
+    byte a[4], b[2], c[6], d[1], e[3];
+    const EEPROM_25xx::ReadSegment reads[] = {{100, a}, {10, b}, {14, c}, {16, d}, {500, e}};
+    const dword frames = spi.getBusStats(EEPROM_25xx::CMD_READ).transactions;
+    assert(eeprom.readv(reads) == 3); // [10; 20), [100; 104), [500; 503)
+    assert(spi.getBusStats(EEPROM_25xx::CMD_READ).transactions == frames + 3);
+    for (const EEPROM_25xx::ReadSegment& segment : reads)
+        for (array_size i = 0; i < segment.buffer.size(); ++i)
+            assert(segment.buffer[i] == image[segment.address + i]);
+
+    // Zero gap reads every disjoint range by its own frame
+    assert(eeprom.readv(reads, 0) == 4);
+
+    // Pieces of the same page share burst, gap is read and written back, range of two pages is split
+    const dword cycles = spi.getWriteCycleCount();
+    const byte first[] = {0xA1, 0xA2}, second[] = {0xB1}, third[] = {0xC1, 0xC2, 0xC3, 0xC4};
+    const pointer_size PAGE = 4 * EEPROM_25LC040A::PAGE_SIZE;
+    const EEPROM_25xx::WriteSegment writes[] = {{PAGE + 9, second}, {PAGE + 1, first}, {PAGE + EEPROM_25LC040A::PAGE_SIZE - 2, third}};
+    assert(eeprom.writev(writes) == 2);
+    assert(spi.getWriteCycleCount() == cycles + 2);
+    const auto result = spi.getByteArrayByAddress(0);
+    for (const EEPROM_25xx::WriteSegment& segment : writes)
+        for (array_size i = 0; i < segment.data.size(); ++i)
+            image[segment.address + i] = segment.data[i];
+    for (pointer_size i = 0; i <= EEPROM_25LC040A::MAX_ADDRESS; ++i)
+        assert(result[i] == image[i]);
+
+    // Without gap merging every piece is its own burst
+    assert(eeprom.writev(writes, 0) == 4);
+
+    // Overlapping writes, empty ranges and ranges beyond device are rejected
+    const EEPROM_25xx::WriteSegment overlapping[] = {{20, third}, {22, first}};
+    assert(eeprom.tryWritev(overlapping).error() == ERROR_INVALID_ARGUMENT);
+    const EEPROM_25xx::ReadSegment beyond[] = {{EEPROM_25LC040A::MAX_ADDRESS, b}};
+    assert(eeprom.tryReadv(beyond).error() == ERROR_OUT_OF_RANGE);
+    assert(eeprom.tryReadv({}).error() == ERROR_INVALID_ARGUMENT);
+    bool thrown = false;
+    try {
+        eeprom.writev(overlapping);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testCacheWriteBack() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    const pointer_size PAGE = (std::rand() % 32) * EEPROM_25LC040A::PAGE_SIZE; // random page [0; 31]
+
+    // Make EEPROM and cache
+    EEPROM_25LC040A eeprom(&spi);
+    EEPROM_25LC040A_Cache cache(&eeprom);
+
+    // Update every byte of page many times and one byte of next page
+    for (byte value = 1; value <= 100; ++value)
+        for (pointer_size i = 0; i < EEPROM_25LC040A::PAGE_SIZE; ++i)
+            cache.writeByte(PAGE + i, value + i);
+    const pointer_size NEXT = (PAGE + EEPROM_25LC040A::PAGE_SIZE) % (EEPROM_25LC040A::MAX_ADDRESS + 1);
+    cache.writeByte(NEXT, 0xA5);
+
+    // Nothing is written yet, reads are served from mirror
+    assert(spi.getWriteCycleCount() == 0);
+    assert(cache.readByte(PAGE) == 100);
+    assert(spi.getByteArrayByAddress(PAGE)[0] == 0);
+
+    // Only two dirty pages are written
+    assert(cache.flush() == 2);
+    assert(spi.getWriteCycleCount() == 2);
+    assert(cache.dirtyPages() == 0);
+
+    const auto result = spi.getByteArrayByAddress(0);
+    for (pointer_size i = 0; i < EEPROM_25LC040A::PAGE_SIZE; ++i)
+        assert(result[PAGE + i] == 100 + i);
+    assert(result[NEXT] == 0xA5);
+
+    // Writing the same data doesn't make page dirty
+    cache.writeByte(NEXT, 0xA5);
+    assert(cache.flush() == 0);
+}
+
+void testStreambuf() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    EEPROM_25LC040A eeprom(&spi);
+    const pointer_size BASE = 3 * EEPROM_25LC040A::PAGE_SIZE + 5; // unaligned region start
+    const pointer_size LENGTH = 100;
+
+    // Region must fit device
+    bool thrown = false;
+    try {
+        EEPROM_25LC040A_Streambuf invalid(&eeprom, EEPROM_25LC040A::MAX_ADDRESS, 2);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // 90 characters are written by page bursts, tellp doesn't write put area
+    EEPROM_25LC040A_Stream stream(&eeprom, BASE, LENGTH);
+    for (byte i = 0; i < 90; ++i)
+        stream.put('a' + i % 26);
+    assert(stream.tellp() == 90);
+    assert(spi.getWriteCycleCount() == 5);
+    assert(stream.flush());
+    assert(spi.getWriteCycleCount() == 6);
+    const auto image = spi.getByteArrayByAddress(0);
+    for (pointer_size i = 0; i < 90; ++i)
+        assert(image[BASE + i] == 'a' + i % 26);
+    assert(image[BASE - 1] == 0 && image[BASE + 90] == 0);
+
+    // Reads fetch whole page: reading back within page is served from buffer
+    assert(stream.seekg(27)); // page aligned
+    const dword reads = spi.getBusStats(EEPROM_25xx::CMD_READ).transactions;
+    char word[4] = {};
+    assert(stream.read(word, 3) && std::string(word) == "bcd");
+    assert(stream.seekg(-3, std::ios_base::cur));
+    assert(stream.get() == 'b');
+    assert(spi.getBusStats(EEPROM_25xx::CMD_READ).transactions == reads + 1);
+    assert(stream.tellg() == 28);
+
+    // Overwrite in the middle keeps neighbours
+    assert(stream.seekp(1) && stream.write("XY", 2) && stream.flush());
+    assert(stream.seekg(0) && stream.read(word, 3) && std::string(word) == "aXY");
+
+    // Input and output share position: put-only seek moves get position too
+    assert(stream.seekp(2) && stream.tellg() == 2 && stream.get() == 'Y');
+
+    // Region end is end of file for both directions
+    assert(stream.seekp(LENGTH - 1) && stream.put('!'));
+    assert(!stream.put('?'));
+    stream.clear();
+    assert(!stream.seekg(LENGTH + 1));
+    stream.clear();
+    assert(stream.seekg(-1, std::ios_base::end) && stream.get() == '!');
+    assert(stream.get() == std::char_traits<char>::eof() && stream.eof());
+    assert(spi.getByteArrayByAddress(BASE + LENGTH)[0] == 0);
+
+    // Whole 64 KiB device: region length and last page end don't fit in address word
+    BasicMockSpi<EEPROM_25LC512_Traits> wide;
+    wide.setWriteCycleTime(std::chrono::microseconds{0});
+    BasicEEPROM_25xx<EEPROM_25LC512_Traits, ISpiBitBang> large(&wide);
+    BasicEEPROM_25xxStream<decltype(large)> whole(&large);
+    assert(whole.seekp(0, std::ios_base::end) && whole.tellp() == 65536);
+    assert(whole.seekp(-2, std::ios_base::end) && whole.write("Z!", 2) && whole.flush());
+    assert(wide.getByteArrayByAddress(EEPROM_25LC512_Traits::MAX_ADDRESS - 1)[0] == 'Z');
+    assert(whole.seekg(-1, std::ios_base::end) && whole.get() == '!');
+    assert(whole.get() == std::char_traits<char>::eof());
+}
+
+void testKvStore() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    EEPROM_25LC040A eeprom(&spi);
+
+    // Fresh device is formatted, 40 settings of 2 bytes are appended
+    EEPROM_25LC040A_KvStore store(&eeprom);
+    for (byte key = 0; key < 40; ++key) {
+        const byte value[2] = {key, static_cast<byte>(~key)};
+        store.put(key, value);
+    }
+    assert(store.size() == 40);
+
+    // Update costs single partial page burst, lookups don't use bus
+    const dword cycles = spi.getWriteCycleCount();
+    const dword payload = spi.getBusStats(EEPROM_25xx::CMD_WRITE).payload;
+    const byte UPDATE[2] = {0xAB, 0xCD};
+    store.put(7, UPDATE);
+    assert(spi.getWriteCycleCount() == cycles + 1);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_WRITE).payload == payload + 5);
+    const dword transactions = spi.getBusStats().transactions;
+    assert(store.get(7).size() == 2 && store.get(7)[0] == 0xAB && store.get(7)[1] == 0xCD);
+    assert(!store.contains(40) && store.get(40).empty());
+    assert(spi.getBusStats().transactions == transactions);
+
+    // Unchanged value isn't written, removed key is gone
+    store.put(7, UPDATE);
+    assert(spi.getWriteCycleCount() == cycles + 1);
+    assert(store.remove(39) && !store.remove(39));
+
+    // Updates fill segment and trigger compaction, index is rebuilt on mount
+    for (dword round = 0; round < 100; ++round) {
+        const byte value[3] = {static_cast<byte>(round), 1, 2};
+        store.put(round % 5, value);
+    }
+    EEPROM_25LC040A_KvStore mounted(&eeprom);
+    assert(mounted.size() == 39 && mounted.used() == store.used());
+    for (byte key = 0; key <= EEPROM_25LC040A_KvStore::MAX_KEY; ++key) {
+        const auto expected = store.get(key);
+        const auto actual = mounted.get(key);
+        assert(expected.size() == actual.size() && std::equal(expected.begin(), expected.end(), actual.begin()));
+    }
+    assert(mounted.get(4)[0] == 99 && mounted.get(7)[1] == 0xCD && !mounted.contains(39));
+
+    // Live records which don't fit segment are rejected
+    byte big[EEPROM_25LC040A_KvStore::MAX_VALUE_SIZE]{};
+    bool thrown = false;
+    try {
+        for (byte key = 100; key < 120; ++key)
+            mounted.put(key, big);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testCounter() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    EEPROM_25LC040A eeprom(&spi);
+
+    // Fresh region is reset to 0
+    EEPROM_25LC040A_Counter counter(&eeprom, 256, 64);
+    assert(counter.value() == 0 && counter.cells() == 64 - EEPROM_25LC040A_Counter::HEADER_SIZE);
+
+    // Every increment is single byte write, cells are written in turn
+    const dword cycles = spi.getWriteCycleCount();
+    const dword payload = spi.getBusStats(EEPROM_25xx::CMD_WRITE).payload;
+    for (dword i = 1; i <= 1000; ++i)
+        assert(counter.increment() == i);
+    assert(spi.getWriteCycleCount() == cycles + 1000);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_WRITE).payload == payload + 1000);
+
+    // Value is recovered by single read
+    const dword reads = spi.getBusStats(EEPROM_25xx::CMD_READ).transactions;
+    EEPROM_25LC040A_Counter loaded(&eeprom, 256, 64);
+    assert(loaded.value() == 1000);
+    assert(spi.getBusStats(EEPROM_25xx::CMD_READ).transactions == reads + 1);
+
+    // Short ring: laps byte wraps and header is rewritten once per period
+    EEPROM_25LC040A_Counter fast(&eeprom, 0, EEPROM_25LC040A_Counter::HEADER_SIZE + 3);
+    for (dword i = 0; i < 3 * 700; ++i)
+        fast.increment();
+    fast.load();
+    assert(fast.value() == 3 * 700);
+
+    // Interrupted increment: header of the next period is written, the last cell is not
+    fast.reset(3 * 2 * EEPROM_25LC040A_Counter::HEADER_PERIOD - 1);
+    byte header[EEPROM_25LC040A_Counter::HEADER_SIZE] = {2, 0, 0, 0, 2 ^ 0xA5};
+    spi.setByteArrayByAddress(0, header, sizeof(header));
+    fast.load();
+    assert(fast.value() == 3 * 2 * EEPROM_25LC040A_Counter::HEADER_PERIOD - 1);
+    assert(fast.increment() == 3 * 2 * EEPROM_25LC040A_Counter::HEADER_PERIOD);
+    fast.load();
+    assert(fast.value() == 3 * 2 * EEPROM_25LC040A_Counter::HEADER_PERIOD);
+}
+
+void testNorProgramRead() {
+    MockNorFlash spi;
+    constexpr array_size LENGTH = 3 * NorFlash::PAGE_SIZE;
+    const flash_address ADDRESS = 0x1000 + std::rand() % NorFlash::PAGE_SIZE; // random unaligned address in the second sector
+
+    byte data[LENGTH];
+    for (array_size i = 0; i < LENGTH; ++i)
+        data[i] = std::rand() % 256; // random byte value
+
+    // Make flash
+    NorFlash flash(&spi, MockNorFlash::DEFAULT_CAPACITY);
+
+    // Unaligned range touches 4 pages (3 when address is aligned)
+    const dword bursts = flash.program(ADDRESS, data);
+    assert(bursts == (ADDRESS % NorFlash::PAGE_SIZE ? 4 : 3));
+    assert(spi.getProgramCount() == bursts);
+    assert(!flash.isBusy());
+
+    // Every page program is waited for
+    assert(spi.getElapsedTime() >= MockNorFlash::PAGE_PROGRAM_TIME * bursts);
+
+    // "Read" by single streaming frame longer than driver chunk
+    byte result[LENGTH + 2];
+    flash.readInto(ADDRESS - 1, result);
+    assert(result[0] == 0xFF && result[LENGTH + 1] == 0xFF);
+    for (array_size i = 0; i < LENGTH; ++i)
+        assert(result[i + 1] == data[i]);
+
+    // Programming only clears bits
+    const byte ZERO[1] = {0x0F};
+    flash.program(ADDRESS, ZERO);
+    assert(flash.readByte(ADDRESS) == (data[0] & 0x0F));
+
+    // Frame clocked by bytes and bits: READ instruction, the first data byte by bytes, the second one by bits
+    assert(!spi.transferByte(NorFlash::CMD_READ) && !spi.transferBit(1));
+    spi.chipDeselect();
+    for (const byte value : {byte(NorFlash::CMD_READ), byte(ADDRESS >> 16), byte(ADDRESS >> 8), byte(ADDRESS)})
+        spi.transferByte(value);
+    assert(spi.transferByte(0) == (data[0] & 0x0F));
+    byte value = 0;
+    for (byte i = 0; i < 8; ++i)
+        value = value << 1 | spi.transferBit(0);
+    spi.chipSelect();
+    assert(value == data[1]);
+}
+
+void testNorErase() {
+    MockNorFlash spi;
+    spi.setOperationTimes(std::chrono::microseconds{700}, std::chrono::microseconds{450}, std::chrono::microseconds{1500}, std::chrono::microseconds{50000});
+
+    // Make flash
+    NorFlash flash(&spi, MockNorFlash::DEFAULT_CAPACITY);
+    const byte DATA[4] = {0, 0, 0, 0};
+    for (flash_address address = 0; address < 3 * NorFlash::BLOCK_SIZE; address += NorFlash::SECTOR_SIZE)
+        flash.program(address, DATA);
+    const dword programs = spi.getProgramCount();
+
+    // Sector before block, whole block, sector after block
+    const auto start = spi.getElapsedTime();
+    assert(flash.erase(NorFlash::BLOCK_SIZE - NorFlash::SECTOR_SIZE, NorFlash::BLOCK_SIZE + 2 * NorFlash::SECTOR_SIZE) == 3);
+    assert(spi.getEraseCount() == 3);
+    assert(spi.getElapsedTime() - start >= std::chrono::microseconds{2 * 450 + 1500});
+
+    for (flash_address address = 0; address < 3 * NorFlash::BLOCK_SIZE; address += NorFlash::SECTOR_SIZE) {
+        const bit erased = address >= NorFlash::BLOCK_SIZE - NorFlash::SECTOR_SIZE && address <= 2 * NorFlash::BLOCK_SIZE;
+        assert(spi.getByteArrayByAddress(address)[0] == (erased ? 0xFF : 0x00));
+    }
+
+    // Whole device is erased by single instruction
+    assert(flash.erase(0, MockNorFlash::DEFAULT_CAPACITY) == 1);
+    assert(spi.getByteArrayByAddress(0)[0] == 0xFF);
+    assert(spi.getProgramCount() == programs);
+}
+
+void testBusArbiterThreads() {
+    constexpr dword ROUNDS = 20;
+    MockSpi chips[3];
+    for (MockSpi& chip : chips)
+        chip.setWriteCycleTime(std::chrono::microseconds{100});
+    MockNorFlash nor;
+    MockSpiBus wires({&chips[0], &chips[1], &chips[2], &nor});
+
+    // Every chip has its own handle, driver and thread
+    SpiBus bus(&wires);
+    SpiBus::Device devices[4] = {{bus, wires.line(0)}, {bus, wires.line(1)}, {bus, wires.line(2)}, {bus, wires.line(3)}};
+    std::thread threads[4];
+    for (dword i = 0; i < 3; ++i) {
+        threads[i] = std::thread([&, i] {
+            EEPROM_25LC040A eeprom(&devices[i]);
+            byte data[EEPROM_25LC040A::PAGE_SIZE * 2];
+            byte buffer[sizeof(data)];
+            for (dword round = 0; round < ROUNDS; ++round) {
+                for (dword j = 0; j < sizeof(data); ++j)
+                    data[j] = i * 64 + round + j;
+                eeprom.writeByteArray(round * 8, data, sizeof(data));
+                eeprom.readInto(round * 8, buffer);
+                assert(!std::memcmp(data, buffer, sizeof(data)));
+            }
+        });
+    }
+    threads[3] = std::thread([&] {
+        NorFlash flash(&devices[3], MockNorFlash::DEFAULT_CAPACITY);
+        byte data[NorFlash::PAGE_SIZE + 16];
+        byte buffer[sizeof(data)];
+        for (dword round = 0; round < ROUNDS; ++round) {
+            for (dword j = 0; j < sizeof(data); ++j)
+                data[j] = round ^ j;
+            flash.program(round * NorFlash::SECTOR_SIZE + 8, data);
+            flash.readInto(round * NorFlash::SECTOR_SIZE + 8, buffer);
+            assert(!std::memcmp(data, buffer, sizeof(data)));
+        }
+    });
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Frames are serialised: no chip is selected while other one is
+    assert(wires.getCollisionCount() == 0);
+    assert(bus.getBatchCount() > 0 && bus.getBatchCount() <= bus.getFrameCount());
+    dword frames = 0;
+    for (const MockSpi& chip : chips)
+        frames += chip.getBusStats().transactions;
+    assert(frames < bus.getFrameCount());
+
+    // Single bytes and bits are clocked inside frame of handle only: STATUS register read by byte and bits
+    bool thrown = false;
+    try {
+        devices[0].transferByte(EEPROM_25xx::CMD_RDSR);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        wires.transferBit(0);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    devices[0].chipDeselect();
+    devices[0].transferByte(EEPROM_25xx::CMD_RDSR);
+    byte status = 0;
+    for (byte i = 0; i < 8; ++i)
+        status = status << 1 | devices[0].transferBit(0);
+    devices[0].chipSelect();
+    assert(!(status & EEPROM_25xx::SR_WIP));
+}
+
+void testScheduler() {
+    constexpr dword THREADS = 4;
+    constexpr dword FIELDS = 8;
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{100});
+    EEPROM_25LC040A eeprom(&spi);
+    EEPROM_25LC040A_Scheduler scheduler(&eeprom);
+
+    // Read, write, read of the same byte submitted at once: every read sees writes submitted before it only
+    const byte first = 0x11, second = 0x22;
+    byte before = 0xFF, after = 0xFF;
+    auto write1 = scheduler.write(300, std::span<const byte>(&first, 1));
+    auto read1 = scheduler.read(300, std::span<byte>(&before, 1));
+    auto write2 = scheduler.write(300, std::span<const byte>(&second, 1));
+    auto read2 = scheduler.read(300, std::span<byte>(&after, 1));
+    assert(write1.get() && read1.get() && write2.get() && read2.get());
+    assert(before == first && after == second);
+
+    // Threads write interleaved fields: fields of the same page share bursts
+    const dword cycles = spi.getWriteCycleCount();
+    std::thread threads[THREADS];
+    for (dword i = 0; i < THREADS; ++i) {
+        threads[i] = std::thread([&, i] {
+            byte data[FIELDS][4];
+            std::future<Result<void>> futures[FIELDS];
+            for (dword j = 0; j < FIELDS; ++j) {
+                for (byte k = 0; k < 4; ++k)
+                    data[j][k] = i * 32 + j * 4 + k;
+                futures[j] = scheduler.write(j * 16 + i * 4, data[j]);
+            }
+            for (std::future<Result<void>>& future : futures)
+                assert(future.get());
+
+            byte buffer[FIELDS][4];
+            for (dword j = 0; j < FIELDS; ++j)
+                futures[j] = scheduler.read(j * 16 + i * 4, buffer[j]);
+            for (std::future<Result<void>>& future : futures)
+                assert(future.get());
+            assert(!std::memcmp(data, buffer, sizeof(data)));
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // 32 writes touch 8 pages: writes queued while worker waits for write cycle are coalesced
+    assert(spi.getWriteCycleCount() - cycles < THREADS * FIELDS);
+    assert(scheduler.getBatchCount() < scheduler.getRequestCount());
+    assert(scheduler.getEpochCount() >= scheduler.getBatchCount());
+    const auto result = spi.getByteArrayByAddress(0);
+    for (dword i = 0; i < THREADS * FIELDS * 4; ++i)
+        assert(result[i] == (i % 16 / 4) * 32 + i / 16 * 4 + i % 4);
+
+    // Invalid requests are completed at once
+    byte buffer[2];
+    assert(scheduler.read(EEPROM_25LC040A::MAX_ADDRESS, buffer).get().error() == ERROR_OUT_OF_RANGE);
+    assert(scheduler.write(0, {}).get().error() == ERROR_INVALID_ARGUMENT);
+}
+
+void testBitBang() {
+    MockSpi spi;
+    spi.setWriteCycleTime(std::chrono::microseconds{0});
+    MockSpiPins pins(&spi);
+    byte data[EEPROM_25LC040A::PAGE_SIZE * 2];
+    for (byte i = 0; i < sizeof(data); ++i)
+        data[i] = i * 37 + 5;
+
+    // Mode 0 backend bound at compile time: writes cross page and device end, STATUS register is polled through pins
+    BasicSpiBitBang<MockSpiPins> mode0(&pins);
+    BasicEEPROM_25LC040A<BasicSpiBitBang<MockSpiPins>> eeprom(&mode0);
+    eeprom.writeByteArray(0x1FA, data, sizeof(data));
+    assert(spi.getWriteCycleCount() == 3);
+    byte buffer[sizeof(data)];
+    eeprom.readInto(0x1FA, buffer);
+    assert(!std::memcmp(data, buffer, sizeof(data)));
+    assert(spi.getByteArrayByAddress(0)[(0x1FA + sizeof(data) - 1) % (EEPROM_25LC040A::MAX_ADDRESS + 1)] == data[sizeof(data) - 1]);
+
+    // Mode 3 backend over runtime polymorphic pins reads the same data
+    BasicSpiBitBang<IGpioPins, SPI_MODE_3> mode3(&pins);
+    EEPROM_25LC040A runtime(&mode3);
+    assert(runtime.readByte(0x1FB) == data[1]);
+    assert(mode3.transfer(data, {}) == TRANSFER_INVALID_STATE);
+
+    // Byte read frame: 3 bytes of 16 SCK edges, CS edges, MOSI toggles once up and once down. No pin write is redundant
+    eeprom.readByte(0);
+    pins.resetPinStats();
+    eeprom.readByte(0);
+    assert(pins.getEdgeCount() == 3 * 16 + 2 + 2);
+    assert(pins.getWriteCount() == pins.getEdgeCount());
+
+    // Loopback records bits in order of sending
+    struct Loopback {
+        bit sck{false}, mosi{false};
+        byte bits{0};
+        void writeSck(const bit level) { if (level && !sck) bits = bits << 1 | mosi; sck = level; }
+        void writeMosi(const bit level) { mosi = level; }
+        void writeCs(const bit) {}
+        bit readMiso() { return mosi; }
+    } loopback;
+    BasicSpiBitBang<Loopback, SPI_MODE_0, LSB_FIRST> lsb(&loopback);
+    bool thrown = false;
+    try {
+        lsb.transferByte(0x01);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && !loopback.bits); // Not selected: nothing is clocked
+    lsb.chipDeselect();
+    assert(lsb.transferByte(0x01) == 0x01);
+    assert(loopback.bits == 0x80);
+
+    // Mock device clocked bit by bit: READ instruction of 0x1FB, then data byte MSB first
+    const byte instruction[2] = {static_cast<byte>(EEPROM_25xx::CMD_READ | 0x08), 0xFB};
+    assert(!spi.transferBit(1));
+    spi.chipDeselect();
+    for (const byte value : instruction)
+        for (int i = 7; i >= 0; --i)
+            spi.transferBit(value >> i & 1);
+    byte value = 0;
+    for (int i = 0; i < 8; ++i)
+        value = value << 1 | spi.transferBit(0);
+    spi.chipSelect();
+    assert(value == data[1]);
+}
+
+void testSpiTrace() {
+    MockSpi field;
+    field.setWriteCycleTime(std::chrono::microseconds{0});
+    SpiTraceRecorder recorder(&field);
+
+    // Record workload of driver: page bursts, STATUS polls, reads and bit read-modify-write
+    EEPROM_25LC040A eeprom(&recorder);
+    byte image[EEPROM_25LC040A::MAX_ADDRESS + 1];
+    for (pointer_size i = 0; i < sizeof(image); ++i)
+        image[i] = i * 7;
+    eeprom.writeByteArray(0x13, image, 100);
+    eeprom.writeBit(0x200 - 1, 1);
+    for (pointer_size i = 0; i < 16; ++i)
+        eeprom.readByte(i * 32);
+    assert(recorder.getDroppedCount() == 0);
+
+    // Replay reproduces content and frames on another device
+    const std::vector<byte> trace = recorder.snapshot();
+    MockSpi lab;
+    lab.setWriteCycleTime(std::chrono::microseconds{0});
+    const Result<SpiTraceStats> stats = replaySpiTrace(trace, &lab);
+    assert(stats.ok());
+    assert(stats.value().frames == field.getBusStats().transactions);
+    assert(stats.value().events == recorder.getRecordCount());
+    assert(stats.value().bytes * 8 == field.getBusStats().clocks);
+    assert(lab.getBusStats().transactions == field.getBusStats().transactions);
+    assert(lab.getWriteCycleCount() == field.getWriteCycleCount());
+    assert(!std::memcmp(lab.getByteArrayByAddress(0), field.getByteArrayByAddress(0), EEPROM_25LC040A::MAX_ADDRESS + 1));
+
+    // Frame of byte read is 4 records: chip deselect, instruction, data and chip select
+    recorder.clear();
+    eeprom.readByte(5);
+    assert(recorder.getRecordCount() == 4);
+    assert(recorder.snapshot().size() <= sizeof(SpiTraceRecorder::MAGIC) + 24);
+
+    // Malformed trace is rejected
+    assert(replaySpiTrace(std::span<const byte>(trace.data(), 2), &lab).error() == ERROR_INVALID_ARGUMENT);
+    assert(replaySpiTrace(std::span<const byte>(trace.data(), trace.size() - 1), &lab).error() == ERROR_INVALID_ARGUMENT);
+    assert(replaySpiTrace(trace, nullptr).error() == ERROR_NO_BACKEND);
+
+    // Full ring drops the oldest records, the rest is still decodable
+    SpiTraceRecorder ring(&field, 64);
+    EEPROM_25LC040A small(&ring);
+    for (pointer_size i = 0; i < 100; ++i)
+        small.readByte(i);
+    assert(ring.getDroppedCount() > 0);
+    assert(ring.getRecordCount() + ring.getDroppedCount() == 400);
+    MockSpi replica;
+    const Result<SpiTraceStats> tail = replaySpiTrace(ring.snapshot(), &replica);
+    assert(tail.ok() && tail.value().events == ring.getRecordCount());
+
+    // Bits are replayed, transfer errors are reported, oversized transfer is rejected before it is clocked
+    const byte bits[] = {'S', 'P', 'T', '1', TRACE_CHIP_DESELECT, 0, TRACE_BIT, 0, TRACE_BIT | 0x80, 0, TRACE_CHIP_SELECT, 0};
+    const Result<SpiTraceStats> clocked = replaySpiTrace(bits, &replica);
+    assert(clocked.ok() && clocked.value().transfers == 2 && clocked.value().frames == 1);
+    const byte invalid[] = {'S', 'P', 'T', '1', TRACE_CHIP_DESELECT, 0, TRACE_TRANSFER, 0, 1, 0xFF, 0, TRACE_CHIP_SELECT, 0};
+    assert(replaySpiTrace(invalid, &replica).error() == ERROR_INVALID_INSTRUCTION);
+    replica.chipSelect();
+    const byte oversized[] = {'S', 'P', 'T', '1', TRACE_CHIP_DESELECT, 0, TRACE_TRANSFER, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F};
+    assert(replaySpiTrace(oversized, &replica).error() == ERROR_INVALID_ARGUMENT);
 }